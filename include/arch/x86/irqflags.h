@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+// 인터럽트를 막고 이전 EFLAGS를 돌려줌 (중첩 가능한 짧은 임계 구역용)
+static inline uint32_t irq_save(void) {
+    uint32_t flags;
+    __asm__ __volatile__("pushf\n\tpop %0\n\tcli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+// irq_save 이전에 인터럽트가 켜져 있었을 때만 다시 켬
+static inline void irq_restore(uint32_t flags) {
+    if (flags & 0x200) {  // EFLAGS.IF
+        __asm__ __volatile__("sti" : : : "memory");
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+// PIT 채널 2로 TSC 주파수 보정 (부팅 초기에 한 번 호출)
+void tsc_init(void);
+
+// 현재 TSC 값
+static inline uint64_t tsc_read(void) {
+    uint32_t lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// TSC 주파수 (kHz, 보정 전이면 0)
+uint32_t tsc_get_khz(void);
+
+// TSC 사이클 수를 마이크로초로 변환 (보정 전이면 0)
+uint32_t tsc_cycles_to_us(uint64_t cycles);
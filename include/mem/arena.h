@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Arena (region) 할당자
+// 같이 죽는 임시 객체들(태스크 생성, ELF 로딩, 메시지 묶음 등)을 포인터 증가만으로 할당하고
+// arena_reset / arena_destroy 한 번에 통째로 반환 (객체별 free 없음)
+//
+// - chunk는 PMM에서 2^order 페이지 단위로 받고, arena 구조체 자체는 첫 chunk 안에 둠
+// - 현재 chunk가 모자라면 새 chunk를 앞에 붙임 -> 해제 비용은 객체 수가 아니라 chunk 수에 비례
+// - arena_mark / arena_release로 LIFO 구간을 중첩해서 되돌릴 수 있음 (scratch 용도)
+// - parent를 주면 chunk를 PMM 대신 parent arena에서 받음 (parent를 reset하면 같이 사라짐)
+// - arena_create_heap은 chunk를 kmalloc에서 받음 (페이지보다 작은 chunk, 태스크별 힙 등)
+// - 잠금 없음: arena 하나는 한 태스크(또는 한 경로)만 사용해야 함, IRQ 안에서 사용 금지
+//   (chunk를 주고받는 PMM과 전체 페이지 카운터는 IRQ-safe라 서로 다른 arena끼리는 안전)
+
+#define ARENA_ALIGN 8u
+
+typedef struct arena arena_t;
+
+// arena_release로 되돌아갈 위치
+typedef struct {
+    void* chunk;
+    uint8_t* cur;
+    uint32_t used;
+} arena_mark_t;
+
+// chunk_size: 기본 chunk 크기 힌트 (바이트, 0이면 한 페이지, 페이지 2^n 단위로 올림)
+arena_t* arena_create(size_t chunk_size);
+arena_t* arena_create_nested(arena_t* parent, size_t chunk_size);
+// chunk_size: 0이면 2KB, 8바이트 단위로 올림
+arena_t* arena_create_heap(size_t chunk_size);
+
+// 내용은 초기화되지 않음, 실패 시 NULL
+void* arena_alloc(arena_t* arena, size_t size);
+void* arena_alloc_aligned(arena_t* arena, size_t size, size_t align);
+
+// 첫 chunk만 남기고 모두 반환
+void arena_reset(arena_t* arena);
+void arena_destroy(arena_t* arena);
+
+// 중첩 scratch 구간: mark 이후의 할당을 모두 되돌림 (mark는 LIFO 순서로 release)
+arena_mark_t arena_mark(arena_t* arena);
+void arena_release(arena_t* arena, arena_mark_t mark);
+
+// 통계
+uint32_t arena_used_bytes(const arena_t* arena);     // 할당된 바이트 (정렬 패딩 포함)
+uint32_t arena_chunk_count(const arena_t* arena);
+uint32_t arena_total_pages(void);                    // PMM에서 받은 모든 arena 페이지
@@ -3,16 +3,52 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+// 힙 최소 크기 (초기 크기, 축소해도 이 아래로 줄지 않음)
+#define KMALLOC_MIN_HEAP_SIZE (4 * 4096)
+
+// 기본 축소 임계값: 이 크기 이상의 free 블록이 생기면 그 페이지를 PMM에 반환
+#define KMALLOC_SHRINK_THRESHOLD_DEFAULT (64 * 1024)
+
 // 커널 힙 할당자 초기화
 void kmalloc_init(void);
 
 // 메모리 할당 (size 바이트)
 void* kmalloc(size_t size);
 
+// align 바이트 경계에 정렬된 할당 (align은 2의 거듭제곱, kfree로 해제)
+void* kmalloc_aligned(size_t size, size_t align);
+
+// count 페이지를 페이지 경계에 정렬해 할당 (kfree로 해제)
+void* kmalloc_pages(uint32_t count);
+
+// 크기 변경: 가능하면 제자리에서 늘리거나 줄이고, 안 되면 새로 할당해 복사
+// ptr이 NULL이면 kmalloc, size가 0이면 kfree 후 NULL
+// 실패하면 NULL을 돌려주고 원래 블록은 그대로 유지됨
+void* krealloc(void* ptr, size_t size);
+
 // 메모리 해제 (성공: true, 실패: false)
 bool kfree(void* ptr);
 
 // 통계 정보 (모두 헤더 제외한 데이터 크기)
 uint32_t kmalloc_used_bytes(void);   // 할당된 데이터 크기
-uint32_t kmalloc_free_bytes(void);   // 사용 가능한 데이터 크기
-uint32_t kmalloc_total_bytes(void);  // 전체 힙 크기 (헤더 포함)
+uint32_t kmalloc_free_bytes(void);   // 매핑된 free 데이터 크기 (PMM에 반환한 구멍 제외)
+uint32_t kmalloc_hole_bytes(void);   // free 블록 안에서 PMM에 반환되어 매핑이 빠진 바이트
+uint32_t kmalloc_total_bytes(void);  // 매핑된 힙 크기 (헤더 포함, 반환한 페이지 제외)
+uint32_t kmalloc_largest_free_block(void); // 가장 큰 free 블록의 데이터 크기
+
+// ptr 블록이 힙에서 차지하는 바이트 (헤더 + 정렬 포함, 오버헤드 측정용)
+size_t kmalloc_block_bytes(const void* ptr);
+
+// 힙 축소
+uint32_t kmalloc_pages_released(void);           // PMM에 반환한 누적 페이지 수
+void kmalloc_set_shrink_threshold(uint32_t bytes); // 0이면 축소 안 함
+
+// 할당 프로파일러: 켜진 동안의 할당마다 호출 위치(반환 주소)와 요청 크기를 기록해
+// 호출 위치별 live 바이트/개수, 2의 거듭제곱 크기 히스토그램을 유지 (켜기 전 할당은 기록 안 됨)
+// 꺼져 있으면 할당/해제 경로 비용은 분기 하나
+void kmalloc_profile_enable(bool enable);
+bool kmalloc_profile_enabled(void);
+
+// 힙 요약(free 블록 수, 가장 큰 free 블록, 외부 단편화)과 프로파일 결과를 콘솔에 출력
+// 언제든 호출 가능 (출력하는 동안 인터럽트를 막음)
+void kmalloc_profile_dump(void);
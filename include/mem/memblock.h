@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// 부팅 초기 메모리 할당자 (PMM이 올라오기 전 메타데이터 배치용)
+// 멀티부트 메모리 맵의 usable 구간과 예약 구간(커널 이미지, 멀티부트 정보, 1MB 미만)을 관리
+
+// memblock_alloc이 돌려주는 주소의 상한
+// 돌려주는 주소는 물리 주소, vmm_phys_to_virt로 physmap을 거쳐 접근 (부팅 때부터 매핑되어 있음)
+#define MEMBLOCK_ALLOC_LIMIT 0x1000000u
+
+// mbinfo: 멀티부트 정보의 physmap 주소
+void memblock_init(uint32_t magic, void* mbinfo);
+
+// 구간 추가/예약 (예약은 페이지 단위로 바깥쪽으로 확장)
+void memblock_add(uint64_t base, uint64_t size);
+void memblock_reserve(uint64_t base, uint64_t size);
+
+// usable 메모리에서 예약되지 않은 구간을 골라 예약 후 물리 주소 반환 (실패 시 0)
+uint32_t memblock_alloc(uint32_t size, uint32_t align);
+
+// [min_addr, max_addr) 안에서 할당 (4GB 미만만, 실패 시 0, 메시지 없음)
+// physmap 밖(NORMAL zone 위)의 주소는 따로 매핑해야 접근 가능
+uint32_t memblock_alloc_range(uint32_t size, uint32_t align, uint64_t min_addr, uint64_t max_addr);
+
+// usable 메모리 전체 범위 [start, end)
+uint64_t memblock_start_of_memory(void);
+uint64_t memblock_end_of_memory(void);
+
+// usable이면서 예약되지 않은 구간마다 fn(start, end) 호출 (주소 오름차순)
+void memblock_for_each_free_range(void (*fn)(uint64_t start, uint64_t end));
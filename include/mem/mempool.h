@@ -0,0 +1,33 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// 비상용 고정 크기 원소 풀 (IRQ/스케줄러 경로 전용 예비분)
+// 미리 min_nr개를 slab에서 받아 두고, alloc/free는 예비 리스트 push/pop만 함
+// -> 인터럽트 안에서도 O(1), 할당자(kmalloc/slab/PMM)로 들어가거나 콘솔에 찍지 않음
+//
+// - 예비분이 비면 mempool_alloc은 NULL (기다리지 않음), 호출자가 처리
+// - 채우기/넘친 원소 반환은 프로세스 문맥의 mempool_refill이 함
+//   kernel_idle_loop가 mempool_refill_all로 모든 풀을 min_nr에 맞춤
+// - mempool_create / mempool_destroy / mempool_refill은 IRQ 안에서 호출 금지
+
+typedef struct mempool mempool_t;
+
+// elem_size 원소 min_nr개를 미리 확보 (하나라도 못 받으면 NULL)
+mempool_t* mempool_create(const char* name, size_t elem_size, uint32_t min_nr);
+// 풀에서 나간 원소가 모두 돌아와야 성공
+bool mempool_destroy(mempool_t* pool);
+
+// IRQ 안전, O(1)
+void* mempool_alloc(mempool_t* pool);
+void mempool_free(mempool_t* pool, void* elem);
+
+// 예비분을 min_nr로 맞춤 (모자라면 slab에서 받고 넘치면 반환), 옮긴 원소 수
+uint32_t mempool_refill(mempool_t* pool);
+uint32_t mempool_refill_all(void);
+
+// 통계
+uint32_t mempool_available(const mempool_t* pool);   // 예비 리스트에 있는 원소
+uint32_t mempool_in_use(const mempool_t* pool);      // 풀에서 나가 있는 원소
+uint32_t mempool_empty_count(const mempool_t* pool); // 예비분이 비어 NULL을 준 횟수
@@ -6,6 +6,7 @@
 
 // Multiboot2 tag types
 #define MB2_TAG_TYPE_END   0
+#define MB2_TAG_TYPE_CMDLINE 1
 #define MB2_TAG_TYPE_MMAP  6
 
 // Multiboot2 tag header (common structure)
@@ -14,6 +15,13 @@ struct multiboot_tag {
     uint32_t size;
 };
 
+// Boot command line tag (tag type 1)
+struct multiboot_tag_string {
+    uint32_t type;
+    uint32_t size;
+    char string[];  // NUL 종료 문자열
+};
+
 // MMAP tag header (tag type 6)
 struct multiboot_tag_mmap {
     uint32_t type;
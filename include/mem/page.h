@@ -0,0 +1,69 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "mem/pmm.h"
+#include "mem/vmm.h"
+
+// 프레임 디스크립터 (struct page)
+// PMM이 관리하는 프레임마다 하나씩, PFN으로 인덱싱되는 배열로 PMM 메타데이터 옆에 할당됨
+// refcount 0 = free (PMM 소유), 할당 시 1로 시작
+#define PAGE_FLAG_RESERVED  (1u << 0)  // 펌웨어/커널 이미지/메타데이터 등, 해제 불가
+#define PAGE_FLAG_SLAB      (1u << 1)  // slab 캐시가 쓰는 프레임
+#define PAGE_FLAG_PAGETABLE (1u << 2)  // 페이지 디렉토리/테이블
+#define PAGE_FLAG_PINNED    (1u << 3)  // 옮기거나 회수하면 안 되는 프레임
+#define PAGE_FLAG_DIRTY     (1u << 4)  // 내용이 수정됨
+
+typedef struct page {
+    uint32_t flags;
+    int32_t refcount;       // 원자적으로 증감
+    int32_t mapcount;       // 이 프레임을 가리키는 PTE 수
+    uintptr_t private;      // 소유자 전용 (slab: 캐시 포인터 등)
+} page_t;
+
+// PFN(물리 주소 >> 12) <-> 디스크립터 (관리 범위 밖이면 NULL / 0)
+page_t* pfn_to_page(uint32_t pfn);
+uint32_t page_to_pfn(const page_t* page);
+page_t* phys_to_page(phys_addr_t phys);
+phys_addr_t page_to_phys(const page_t* page);
+
+static inline page_t* virt_to_page(const void* addr) {
+    // DMA/NORMAL zone 포인터는 physmap 주소 (물리 주소 + VMM_PHYSMAP_START)
+    return phys_to_page(vmm_virt_to_phys(addr) & ~(uint64_t)(PAGE_SIZE - 1));
+}
+
+static inline int32_t page_ref_count(const page_t* page) {
+    return __atomic_load_n(&page->refcount, __ATOMIC_ACQUIRE);
+}
+
+static inline void page_ref_inc(page_t* page) {
+    __atomic_add_fetch(&page->refcount, 1, __ATOMIC_ACQ_REL);
+}
+
+// 참조를 하나 줄이고 0이 되었으면 true
+static inline bool page_ref_dec_and_test(page_t* page) {
+    return __atomic_sub_fetch(&page->refcount, 1, __ATOMIC_ACQ_REL) == 0;
+}
+
+static inline bool page_is_free(const page_t* page) {
+    return page_ref_count(page) == 0;
+}
+
+static inline bool page_test_flag(const page_t* page, uint32_t flag) {
+    return (__atomic_load_n(&page->flags, __ATOMIC_RELAXED) & flag) != 0;
+}
+
+static inline void page_set_flag(page_t* page, uint32_t flag) {
+    __atomic_or_fetch(&page->flags, flag, __ATOMIC_RELAXED);
+}
+
+static inline void page_clear_flag(page_t* page, uint32_t flag) {
+    __atomic_and_fetch(&page->flags, ~flag, __ATOMIC_RELAXED);
+}
+
+// 공유 프레임 참조 추가/해제 (마지막 참조가 풀리면 PMM으로 반환)
+static inline void page_get(page_t* page) {
+    page_ref_inc(page);
+}
+
+void page_put(page_t* page);
@@ -5,14 +5,83 @@
 
 #define PAGE_SIZE 4096u
 
-void pmm_init(uint32_t magic, void* mbinfo);
+// 버디 할당자 최대 order (2^10 페이지 = 4MB 블록)
+#define PMM_MAX_ORDER 10u
+
+// 물리 주소 (PAE에서는 4GB 위 프레임도 가리킴)
+typedef uint64_t phys_addr_t;
+
+// void* API는 이 주소 미만의 프레임만 돌려줌
+#define PMM_LOW_LIMIT 0x100000000ull
+// PAE 36비트 물리 주소 공간 (64GB)
+#define PMM_MAX_PHYS_ADDR 0x1000000000ull
+
+// 메모리 zone 경계
+//   DMA    [1MB, 16MB)    ISA DMA 가능
+//   NORMAL [16MB, 512MB)  커널이 physmap으로 직접 매핑하는 저위 메모리
+//   HIGH   [512MB, 끝)    직접 매핑 밖 (pmm_alloc_frame + vmm_map_phys)
+#define PMM_DMA_LIMIT    0x1000000ull
+#define PMM_NORMAL_LIMIT 0x20000000ull
+
+typedef enum {
+    PMM_ZONE_ID_DMA = 0,
+    PMM_ZONE_ID_NORMAL,
+    PMM_ZONE_ID_HIGH,
+    PMM_ZONE_COUNT,
+} pmm_zone_id_t;
+
+// 할당 플래그: 허용하는 가장 높은 zone (그 아래 zone으로만 fallback)
+//   PMM_ZONE_DMA    DMA zone에서만 (장치 버퍼)
+//   PMM_ZONE_NORMAL NORMAL -> DMA (기본값: 커널 힙, 페이지 테이블)
+//   PMM_ZONE_HIGH   HIGH -> NORMAL -> DMA (pmm_alloc_frame 전용, void* API에서는 무시)
+#define PMM_ZONE_DMA    (1u << 0)
+#define PMM_ZONE_NORMAL (1u << 1)
+#define PMM_ZONE_HIGH   (1u << 2)
+
+// memblock_init 이후에 호출 (메타데이터를 memblock에서 할당)
+void pmm_init(void);
+// 아래 할당/해제 함수는 내부에서 irq_save로 막으므로 태스크와 IRQ 어디서 불러도 됨
+// void* API의 포인터는 physmap 가상 주소 (vmm_virt_to_phys로 물리 주소를 얻음)
 void* pmm_alloc_page(void);
+// 참조 하나 해제 (page_get으로 공유된 프레임은 마지막 참조에서 실제 반환)
 bool pmm_free_page(void* page);
 
-// 연속된 페이지 할당/해제
+// zone 지정 할당 (flags: PMM_ZONE_*)
+void* pmm_alloc_page_flags(uint32_t flags);
+void* pmm_alloc_pages_flags(uint32_t count, uint32_t flags);
+void* pmm_alloc_order_flags(uint32_t order, uint32_t flags);
+
+// 연속된 페이지 할당/해제 (해제는 공유되지 않은 페이지만)
 void* pmm_alloc_pages(uint32_t count);
 bool pmm_free_pages_range(void* page, uint32_t count);
 
+// 2^order개의 연속 페이지 할당/해제 (블록 크기로 정렬됨)
+void* pmm_alloc_order(uint32_t order);
+bool pmm_free_order(void* page, uint32_t order);
+
+// 프레임 하나를 물리 주소로 할당/해제 (4GB 위 -> HIGH zone -> 아래 zone 순서, 실패 시 0)
+// HIGH 프레임은 vmm_map_phys로 매핑해야 접근 가능
+phys_addr_t pmm_alloc_frame(void);
+bool pmm_free_frame(phys_addr_t frame);
+phys_addr_t pmm_memory_end(void);
+// 커널이 physmap으로 직접 매핑해야 하는 물리 메모리 끝 (DMA + NORMAL zone)
+phys_addr_t pmm_direct_map_end(void);
+
+uint32_t pmm_zone_free_pages(pmm_zone_id_t zone);
+uint32_t pmm_zone_total_pages(pmm_zone_id_t zone);
+// zone 버디의 order별 free 블록 수 (CPU 캐시 제외)
+uint32_t pmm_zone_free_blocks(pmm_zone_id_t zone, uint32_t order);
+
+// 미리 0으로 채운 프레임 (풀에서 O(1), 풀이 비면 즉시 지워서 반환)
+// kernel_idle_loop가 pmm_zero_pool_refill로 풀을 채움
+#define PMM_ZERO_POOL_BATCH 8u
+void* pmm_alloc_zeroed_page(void);
+uint32_t pmm_zero_pool_refill(uint32_t budget);
+uint32_t pmm_zero_pool_count(void);
+uint32_t pmm_zero_pool_hits(void);
+uint32_t pmm_zero_pool_misses(void);
+
 uint32_t pmm_total_pages(void);
 uint32_t pmm_get_free_pages(void);
+uint32_t pmm_init_time_us(void);
 
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Slab 할당자 (Bonwick 방식 object cache)
+// 같은 타입 객체를 2^order 페이지 slab 단위로 묶어 관리하고,
+// 캐시마다 free list를 두어 alloc/free를 O(1)로 처리
+//
+// - slab 프레임은 page_t에 PAGE_FLAG_SLAB + private = slab 포인터로 표시되어
+//   해제 시 객체 주소만으로 slab을 찾음
+// - 새 slab마다 객체 시작 위치를 캐시 라인 단위로 밀어서(colouring)
+//   서로 다른 slab의 같은 번호 객체가 같은 캐시 세트에 몰리지 않게 함
+// - ctor는 slab을 만들 때 객체마다 한 번만 호출됨
+//   호출자는 객체를 free하기 전에 생성자 상태로 되돌려 놓아야 함
+
+#define SLAB_CACHE_LINE     64u
+#define SLAB_MAX_ORDER      3u      // slab 하나는 최대 2^3 페이지
+#define SLAB_NAME_LEN       24u
+
+typedef struct kmem_cache kmem_cache_t;
+typedef void (*kmem_ctor_t)(void* obj);
+
+void kmem_cache_init(void);
+
+// align = 0이면 포인터 크기 정렬
+kmem_cache_t* kmem_cache_create(const char* name, size_t size, size_t align, kmem_ctor_t ctor);
+bool kmem_cache_destroy(kmem_cache_t* cache);
+
+void* kmem_cache_alloc(kmem_cache_t* cache);
+bool kmem_cache_free(kmem_cache_t* cache, void* obj);
+
+// 비어 있는 slab을 모두 PMM에 반환, 반환한 페이지 수
+uint32_t kmem_cache_shrink(kmem_cache_t* cache);
+
+// 통계
+uint32_t kmem_cache_object_size(const kmem_cache_t* cache);
+uint32_t kmem_cache_active_objects(const kmem_cache_t* cache);
+uint32_t kmem_cache_total_objects(const kmem_cache_t* cache);
+uint32_t kmem_cache_slab_count(const kmem_cache_t* cache);
+void kmem_cache_print_stats(void);
@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// 가상으로만 연속인 큰 커널 버퍼 (IPC 링, trace 버퍼, 백 버퍼 등)
+// [VMM_VMALLOC_START, VMM_VMALLOC_END)에서 가상 영역을 잡고
+// 프레임을 한 장씩 PMM에서 받아 매핑하므로 물리 메모리 단편화와 무관
+// 각 영역 뒤에는 매핑하지 않은 가드 페이지가 하나 있어 넘치면 page fault
+void vmalloc_init(void);
+
+// 페이지 단위로 올림해서 할당 (내용은 초기화되지 않음)
+void* vmalloc(size_t size);
+
+// vmalloc이 돌려준 주소만 받음 (성공: true, 실패: false)
+bool vfree(void* addr);
+
+// 통계 (페이지 단위)
+uint32_t vmalloc_used_pages(void);   // 매핑된 페이지 수
+uint32_t vmalloc_free_pages(void);   // 남은 가상 영역 페이지 수
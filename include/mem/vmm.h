@@ -22,31 +22,114 @@
 #define VMM_PCD         (1 << 4)  // Page Cache Disable
 #define VMM_ACCESSED    (1 << 5)  // 접근됨
 #define VMM_DIRTY       (1 << 6)  // 수정됨 (PTE만)
-#define VMM_PAGE_SIZE_4MB (1 << 7) // 4MB 페이지 (PDE만)
+#define VMM_PAGE_SIZE_4MB (1 << 7) // 4MB 페이지 (PDE만, PAE에서는 2MB)
+#define VMM_GLOBAL      (1 << 8)  // 전역 페이지: CR4.PGE가 켜져 있으면 CR3를 바꿔도 TLB에 남음
+
+// PAE: PDPT 4개 엔트리, PD/PT는 각각 512개의 64비트 엔트리
+#define VMM_PAE_PDPT_ENTRIES 4
+#define VMM_PAE_ENTRIES 512
+
+// 페이징 모드 (AUTO: 4GB 위 메모리가 있고 CPU가 지원하면 PAE)
+typedef enum {
+    VMM_PAGING_AUTO = 0,
+    VMM_PAGING_LEGACY,
+    VMM_PAGING_PAE,
+} vmm_paging_mode_t;
 
 // 가상 주소를 페이지 디렉토리/테이블 인덱스로 분해
 #define VMM_PAGE_DIR_INDEX(addr)  (((uint32_t)(addr)) >> 22)
 #define VMM_PAGE_TABLE_INDEX(addr) ((((uint32_t)(addr)) >> 12) & 0x3FF)
 #define VMM_PAGE_OFFSET(addr)     (((uint32_t)(addr)) & 0xFFF)
 
+// PAE 가상 주소 분해 (2 + 9 + 9 + 12비트)
+#define VMM_PAE_PDPT_INDEX(addr)  (((uint32_t)(addr)) >> 30)
+#define VMM_PAE_DIR_INDEX(addr)   ((((uint32_t)(addr)) >> 21) & 0x1FF)
+#define VMM_PAE_TABLE_INDEX(addr) ((((uint32_t)(addr)) >> 12) & 0x1FF)
+
+// 가상 주소 배치 (higher-half 커널)
+// 0x00000000 - 0xBFFFFFFF : 사용자 공간 (커널 페이지 디렉토리에는 매핑 없음, 0번 페이지 포함)
+// 0xC0000000 - 0xDFFFFFFF : physmap (물리 주소 0부터 DMA/NORMAL zone 끝까지 큰 페이지로 선형 매핑)
+//                           커널 이미지는 물리 1MB에 적재되어 0xC0100000에서 실행됨 (linker.ld)
+// 0xE0000000 - 0xEFFFFFFF : kmalloc 힙 arena (프레임 단위로 매핑되며 자람)
+// 0xF0000000 - 0xFE3FFFFF : vmalloc 영역 (큰 버퍼, 물리적으로 비연속)
+// 0xFE400000 - 0xFF3FFFFF : I/O 매핑 창 (vmm_ioremap, 프레임버퍼 등 RAM 밖 장치 메모리)
+// 0xFF400000 - 0xFF7FFFFF : 고정 매핑 (다른 주소 공간의 페이지 테이블을 잠깐 보는 창 등)
+// 0xFF800000 - 0xFFFFFFFF : 페이지 테이블 자기 참조 창
+//                           legacy: PDE[1023] = PD 자신 -> PT i는 0xFFC00000 + i * 4KB, PD는 0xFFFFF000
+//                           PAE:    PD3[508..511] = PD0..3 -> (p, d)의 PT는 0xFF800000 + (p * 512 + d) * 4KB
+#define VMM_PHYSMAP_START 0xC0000000u
+#define VMM_PHYSMAP_END   0xE0000000u
+#define VMM_KHEAP_START 0xE0000000u
+#define VMM_KHEAP_END   0xF0000000u
+#define VMM_VMALLOC_START 0xF0000000u
+#define VMM_VMALLOC_END   0xFE400000u
+#define VMM_IOREMAP_START 0xFE400000u
+#define VMM_IOREMAP_END   0xFF400000u
+#define VMM_FIXMAP_START  0xFF400000u
+#define VMM_SELFMAP_START 0xFF800000u
+#define VMM_USER_END      VMM_PHYSMAP_START
+
+// 커널 절반(0xC0000000 위)의 PT는 vmm_init이 모두 만들어 두고 모든 주소 공간이 같은 PT를 가리킴
+// 그래서 커널 절반 매핑은 어느 주소 공간에서나 같고 VMM_GLOBAL로 만들어짐
+// (자기 참조 창은 주소 공간마다 다르고, 고정 매핑 창은 수시로 바뀌므로 제외)
+
 // VMM 초기화
 void vmm_init(void);
 
+// physmap: 물리 주소 [0, vmm_physmap_size()) <-> 가상 주소 [VMM_PHYSMAP_START, ...) 상수 덧셈 변환
+static inline void* vmm_phys_to_virt(uint64_t phys) {
+    return (void*)(uintptr_t)(VMM_PHYSMAP_START + (uint32_t)phys);
+}
+
+static inline uint64_t vmm_virt_to_phys(const void* virt) {
+    return (uint32_t)(uintptr_t)virt - VMM_PHYSMAP_START;
+}
+
+// physmap이 덮는 바이트 수 (vmm_init 전에는 0)
+uint32_t vmm_physmap_size(void);
+// 큰 페이지(legacy 4MB PSE / PAE 2MB)로 커널 매핑을 만들었는지
+bool vmm_uses_large_pages(void);
+
+// CR4.PGE (전역 페이지) 켜기/끄기, 바꿀 때 전역 엔트리까지 TLB 전체가 비워짐
+// CPU가 PGE를 지원하지 않으면 false (vmm_init이 지원하면 켬)
+bool vmm_cpu_has_pge(void);
+bool vmm_set_global_pages(bool enable);
+bool vmm_global_pages_enabled(void);
+
+// 페이징 모드 선택 (vmm_init 전에 호출해야 적용됨)
+void vmm_set_paging_mode(vmm_paging_mode_t mode);
+vmm_paging_mode_t vmm_get_paging_mode(void);
+bool vmm_cpu_has_pae(void);
+
 // 페이지 디렉토리/테이블 생성 및 관리
 void* vmm_create_page_dir(void);
 void vmm_destroy_page_dir(void* page_dir);
 
 // 페이지 매핑/언매핑
+// 페이지 테이블은 물리 주소가 아니라 자기 참조 창(현재 주소 공간) 또는
+// 고정 매핑 창(다른 주소 공간)으로 접근하므로 프레임 위치에 제한이 없음
 bool vmm_map_page(void* page_dir, void* virt_addr, void* phys_addr, uint32_t flags);
 bool vmm_unmap_page(void* page_dir, void* virt_addr);
 void* vmm_get_phys_addr(void* page_dir, void* virt_addr);
 
+// 64비트 물리 주소 매핑/조회 (PAE에서 4GB 위 프레임용)
+bool vmm_map_phys(void* page_dir, void* virt_addr, uint64_t phys_addr, uint32_t flags);
+uint64_t vmm_lookup_phys(void* page_dir, void* virt_addr);
+
+// 장치 메모리 [phys, phys + size)를 I/O 매핑 창에 매핑하고 phys에 해당하는 가상 주소 반환 (실패 시 NULL)
+// vmm_init 전에도 부를 수 있음: 그때는 부팅 페이지 디렉토리에 바로 보이게 하고 vmm_init이 커널 쪽으로 옮김
+// 창은 앞에서부터 잘라 쓰고 되돌리지 않음 (부팅 때 한 번 매핑하는 장치용)
+void* vmm_ioremap(uint64_t phys, uint32_t size);
+
 // 페이지 디렉토리 활성화 (CR3 레지스터 설정)
 void vmm_switch_page_dir(void* page_dir);
 
 // 현재 활성화된 페이지 디렉토리 가져오기
 void* vmm_get_current_page_dir(void);
 
-// 페이지 디렉토리/테이블 할당 (PMM 사용)
+// vmm_init이 만든 커널 페이지 디렉토리 (커널 전용 가상 영역은 여기에 매핑)
+void* vmm_get_kernel_page_dir(void);
+
+// 페이지 디렉토리/테이블 할당 (PMM 사용, 엔트리/CR3에 그대로 넣는 물리 주소를 주고받음)
 void* vmm_alloc_page_table(void);
 void vmm_free_page_table(void* page_table);
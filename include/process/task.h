@@ -1,6 +1,8 @@
 #pragma once
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
+#include "mem/arena.h"
 
 // 프로세스 상태
 typedef enum {
@@ -33,6 +35,9 @@ typedef struct task_struct {
     
     uint32_t creation_time;         // 생성 시간
     uint32_t cpu_time;              // 누적 CPU 사용 시간
+
+    arena_t* scratch;               // 임시 할당용 arena (처음 쓸 때 생성, task_destroy에서 반환)
+    arena_t* heap;                  // 이 태스크 소유 할당 (task_alloc, reap 때 통째로 반환)
 } task_struct_t;
 
 // 태스크 관리 함수
@@ -50,6 +55,14 @@ void task_set_current(task_struct_t* task);
 uint32_t task_get_next_pid(void);
 task_struct_t* task_get_kernel_task(void);
 
+// 현재 태스크의 scratch arena (arena_mark/arena_release로 구간을 나눠 씀, IRQ 안에서 사용 금지)
+arena_t* task_scratch_arena(void);
+
+// task 소유 할당 (task = NULL이면 현재 태스크)
+// 공용 힙 위의 태스크별 arena에서 받고 개별 해제 없이 태스크가 reap될 때 한꺼번에 반환
+void* task_alloc(task_struct_t* task, size_t size);
+uint32_t task_heap_bytes(const task_struct_t* task);
+
 // 태스크 상태 관리
 void task_set_state(task_struct_t* task, task_state_t state);
 task_state_t task_get_state(task_struct_t* task);
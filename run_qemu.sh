@@ -2,10 +2,12 @@
 set -euo pipefail
 
 ISO="build/archanOS.iso"
+# 게스트 메모리 크기 (예: QEMU_MEM=8G ./run_qemu.sh 로 4GB 위 메모리/PAE 확인)
+QEMU_MEM="${QEMU_MEM:-128M}"
 
 if [ ! -f "$ISO" ]; then
     echo "[run_qemu] $ISO not found. Building it with make..."
     make
 fi
 
-exec qemu-system-i386 -cdrom "$ISO" -no-reboot -no-shutdown
+exec qemu-system-i386 -cdrom "$ISO" -m "$QEMU_MEM" -no-reboot -no-shutdown
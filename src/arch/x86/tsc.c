@@ -0,0 +1,80 @@
+#include "arch/x86/tsc.h"
+#include "drivers/console/console.h"
+#include <stdint.h>
+
+#define PIT_CHANNEL2     0x42
+#define PIT_COMMAND      0x43
+#define PIT_GATE_PORT    0x61
+#define PIT_BASE_HZ      1193182u
+
+// 보정 구간 10ms
+#define TSC_CALIBRATE_MS 10u
+
+// us = (cycles * us_mult) >> TSC_US_SHIFT
+// 64비트 나눗셈(__udivdi3)을 피하기 위해 곱셈/시프트로 변환
+#define TSC_US_SHIFT 22u
+
+static uint32_t tsc_khz = 0;
+static uint32_t tsc_us_mult = 0;
+
+static inline void outb(uint16_t port, uint8_t value) {
+    __asm__ __volatile__("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint8_t inb(uint16_t port) {
+    uint8_t value;
+    __asm__ __volatile__("inb %1, %0" : "=a"(value) : "Nd"(port));
+    return value;
+}
+
+static void console_putu32(uint32_t v) {
+    char buf[11];
+    int idx = 0;
+
+    if (v == 0) {
+        console_putc('0');
+        return;
+    }
+
+    while (v > 0 && idx < 10) {
+        buf[idx++] = (char)('0' + (v % 10));
+        v /= 10;
+    }
+
+    while (idx--) {
+        console_putc(buf[idx]);
+    }
+}
+
+void tsc_init(void) {
+    // 채널 2 게이트 ON, 스피커 출력 OFF
+    outb(PIT_GATE_PORT, (uint8_t)((inb(PIT_GATE_PORT) & ~0x02) | 0x01));
+
+    // 채널 2, lobyte/hibyte, mode 0 (카운트가 0이 되면 OUT2 = 1)
+    uint32_t latch = PIT_BASE_HZ / (1000u / TSC_CALIBRATE_MS);
+    outb(PIT_COMMAND, 0xB0);
+    outb(PIT_CHANNEL2, (uint8_t)(latch & 0xFF));
+    outb(PIT_CHANNEL2, (uint8_t)(latch >> 8));
+
+    uint64_t start = tsc_read();
+    while ((inb(PIT_GATE_PORT) & 0x20) == 0) {
+        // OUT2가 올라갈 때까지 대기
+    }
+    uint64_t end = tsc_read();
+
+    uint32_t cycles = (uint32_t)(end - start);
+    tsc_khz = cycles / TSC_CALIBRATE_MS;
+    tsc_us_mult = tsc_khz ? (1000u << TSC_US_SHIFT) / tsc_khz : 0;
+
+    console_puts("[TSC] Calibrated: ");
+    console_putu32(tsc_khz);
+    console_puts(" kHz\n");
+}
+
+uint32_t tsc_get_khz(void) {
+    return tsc_khz;
+}
+
+uint32_t tsc_cycles_to_us(uint64_t cycles) {
+    return (uint32_t)((cycles * tsc_us_mult) >> TSC_US_SHIFT);
+}
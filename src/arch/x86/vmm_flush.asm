@@ -3,18 +3,41 @@ global vmm_flush
 
 ; void vmm_flush(void* page_dir);
 ; CR3 레지스터에 페이지 디렉토리의 물리 주소를 설정하고 TLB를 플러시함
-; 주의: page_dir는 물리 주소여야 함 (페이징 활성화 전에는 가상 주소 = 물리 주소)
+; 주의: page_dir는 물리 주소여야 함 (physmap 주소가 아님)
 vmm_flush:
     ; 로그는 C에서 출력하므로 여기서는 어셈블리만 수행
     mov eax, [esp + 4]   ; page_dir 주소 (매개변수 - 물리 주소여야 함)
     
     ; CR3에 물리 주소 설정 (하위 12비트는 무시됨, 4KB 정렬 필요)
-    ; 페이징 활성화 전이므로 가상 주소 = 물리 주소
     mov cr3, eax
     
     ; TLB (Translation Lookaside Buffer) 플러시
-    ; CR3을 다시 로드하면 TLB가 자동으로 플러시됨
+    ; CR3을 다시 로드하면 TLB가 자동으로 플러시됨 (CR4.PGE가 켜져 있으면 전역 엔트리는 남음)
     mov eax, cr3
     mov cr3, eax
     
     ret
+
+global vmm_paging_reload
+
+; void vmm_paging_reload(uint32_t cr3, uint32_t cr4);
+; 페이징을 잠깐 끄고 CR4/CR3를 바꾼 뒤 다시 켬 (CR4.PAE는 페이징이 꺼진 상태에서만 바꿀 수 있음)
+; 주의: 페이징이 꺼지는 동안 실행되므로 적재 주소 = 링크 주소인 .boot.text에 둠
+;       현재 주소 공간과 새 주소 공간 모두 이 코드 페이지를 identity 매핑해야 함
+;       스택은 페이징이 다시 켜진 뒤에만 건드림 (ret)
+section .boot.text progbits alloc exec nowrite align=16
+vmm_paging_reload:
+    mov ecx, [esp + 4]   ; 새 CR3 (물리 주소)
+    mov edx, [esp + 8]   ; 새 CR4
+
+    mov eax, cr0
+    and eax, 0x7FFFFFFF  ; CR0.PG 끔
+    mov cr0, eax
+
+    mov cr4, edx
+    mov cr3, ecx
+
+    or eax, 0x80000000   ; CR0.PG 켬 (TLB는 비어 있음)
+    mov cr0, eax
+
+    ret
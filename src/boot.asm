@@ -9,6 +9,12 @@ MULTIBOOT2_ARCH          equ 0
 MULTIBOOT2_HEADER_LENGTH equ multiboot2_header_end - multiboot2_header_start
 MULTIBOOT2_CHECKSUM      equ -(MULTIBOOT2_MAGIC + MULTIBOOT2_ARCH + MULTIBOOT2_HEADER_LENGTH)
 
+; linker.ld의 KERNEL_VIRT_BASE, vmm.h의 VMM_PHYSMAP_START와 같아야 함
+KERNEL_VIRT_BASE         equ 0xC0000000
+BOOT_PHYSMAP_INDEX       equ KERNEL_VIRT_BASE >> 22   ; 768
+BOOT_PHYSMAP_ENTRIES     equ 128                      ; 128 x 4MB = 512MB (NORMAL zone 끝까지)
+BOOT_STACK_SIZE          equ 16384
+
 section .multiboot
 align 8
 multiboot2_header_start:
@@ -22,18 +28,85 @@ multiboot2_header_start:
     dd 8          ; size
 multiboot2_header_end:
 
-section .text
+; 부팅 트램펄린: 적재 주소(물리 1MB 근처)에서 페이징 없이 실행
+; 부팅 페이지 디렉토리를 4MB 페이지로 채우고 페이징을 켠 뒤 higher-half로 점프
+;   PDE[768..895]  0xC0000000 -> 물리 [0, 512MB)  (physmap, 커널 이미지도 여기 있음)
+;   나머지 PDE     identity                        (트램펄린, 0xE0000000 위 프레임버퍼 등)
+; vmm_init이 커널 페이지 디렉토리로 바꾸면 identity 매핑은 사라짐
+section .boot.text progbits alloc exec nowrite align=16
 global _start
 _start:
-    ; 스택 설정
-    mov esp, 0x900000
+    ; eax = multiboot magic, ebx = mbinfo (물리 주소), cpuid 전에 보관
+    mov esi, eax
+    mov edi, ebx
+
+    ; 4MB 페이지(PSE)가 없으면 진행 불가
+    mov eax, 1
+    cpuid
+    test edx, 1 << 3
+    jz .no_pse
+
+    mov ebx, boot_page_dir - KERNEL_VIRT_BASE
+    xor ecx, ecx
+.fill:
+    mov eax, ecx
+    cmp ecx, BOOT_PHYSMAP_INDEX
+    jb .entry
+    cmp ecx, BOOT_PHYSMAP_INDEX + BOOT_PHYSMAP_ENTRIES
+    jae .entry
+    sub eax, BOOT_PHYSMAP_INDEX
+.entry:
+    shl eax, 22
+    or eax, 0x83                        ; Present | Writable | 4MB
+    mov [ebx + ecx * 4], eax
+    inc ecx
+    cmp ecx, 1024
+    jb .fill
 
-    push ebx        ; mb_info
-    push eax        ; magic
+    mov eax, cr4
+    or eax, 0x10                        ; CR4.PSE
+    mov cr4, eax
+
+    mov cr3, ebx
+
+    mov eax, cr0
+    or eax, 0x80000000                  ; CR0.PG
+    mov cr0, eax
+
+    ; 절대 주소 점프로 higher-half 주소의 코드로 넘어감
+    mov eax, higher_half
+    jmp eax
+
+.no_pse:
+    ; VGA 텍스트 버퍼에 직접 표시
+    mov dword [0xB8000], 0x4F534F50     ; "PS"
+    mov dword [0xB8004], 0x4F214F45     ; "E!"
+.halt:
+    cli
+    hlt
+    jmp .halt
+
+section .text
+higher_half:
+    ; 스택 설정 (커널 이미지 .bss 안이라 memblock이 커널과 함께 예약함)
+    mov esp, boot_stack_top
+
+    push edi        ; mb_info (물리 주소)
+    push esi        ; magic
 
     call kernel_main
 
 .hang:
     cli
     hlt
-    jmp .hang
\ No newline at end of file
+    jmp .hang
+
+section .bss
+align 4096
+boot_page_dir:
+    resb 4096
+
+align 16
+boot_stack_bottom:
+    resb BOOT_STACK_SIZE
+boot_stack_top:
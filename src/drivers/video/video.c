@@ -1,9 +1,17 @@
 #include "drivers/video/video.h"
 #include "font/font8x16.h"
+#include "mem/vmm.h"
+
+// VGA 텍스트 버퍼 (커널은 higher-half에서 돌므로 physmap 주소로 접근)
+#define VGA_TEXT_BUFFER ((volatile uint16_t*)vmm_phys_to_virt(0xB8000))
 
 static struct multiboot_tag_framebuffer* g_fb = 0;
 static int g_use_vga_text = 0;
 
+// 프레임버퍼는 RAM 밖 장치 메모리라 physmap에 없음 -> I/O 매핑 창에 매핑한 주소로 씀
+// (framebuffer_addr는 물리 주소, 부팅 identity 매핑은 vmm_init에서 사라짐)
+static uint32_t* g_fb_base = 0;
+
 static struct multiboot_tag_framebuffer* find_fb_tag(void* mbinfo) {
     uint8_t* p = (uint8_t*)mbinfo + 8; // skip total_size, reserved
 
@@ -23,6 +31,11 @@ void video_init(void* mbinfo) {
     struct multiboot_tag_framebuffer* fb = find_fb_tag(mbinfo);
     
     if (fb && fb->framebuffer_bpp == 32) {
+        g_fb_base = (uint32_t*)vmm_ioremap(fb->framebuffer_addr,
+                                           fb->framebuffer_pitch * fb->framebuffer_height);
+    }
+
+    if (g_fb_base) {
         g_fb = fb;
         g_use_vga_text = 0;
     } else {
@@ -35,7 +48,7 @@ void video_init(void* mbinfo) {
 void video_clear_screen(void) {
     if (g_use_vga_text) {
         // VGA text mode (bios)
-        volatile uint16_t* vga = (volatile uint16_t*)0xB8000;
+        volatile uint16_t* vga = VGA_TEXT_BUFFER;
         for (int i = 0; i < 80 * 25; i++) {
             vga[i] = 0x0000; // black background
         }
@@ -47,7 +60,7 @@ void video_clear_screen(void) {
         uint32_t width  = g_fb->framebuffer_width;
         uint32_t height = g_fb->framebuffer_height;
         uint32_t pitch  = g_fb->framebuffer_pitch;
-        uint32_t* buffer = (uint32_t*)(uintptr_t)g_fb->framebuffer_addr;
+        uint32_t* buffer = g_fb_base;
 
         for (uint32_t y = 0; y < height; y++) {
             uint32_t* row = (uint32_t*)((uint8_t*)buffer + pitch * y);
@@ -65,7 +78,7 @@ void video_draw_char(int cx, int cy, char c) {
         if (cx < 0 || cx >= 80 || cy < 0 || cy >= 25)
             return;
 
-        volatile uint16_t* vga = (volatile uint16_t*)0xB8000;
+        volatile uint16_t* vga = VGA_TEXT_BUFFER;
         int pos = cy * 80 + cx;
         vga[pos] = 0x0700 | (uint8_t)c; // black background, light gray text
     } else {
@@ -80,7 +93,7 @@ void video_draw_char(int cx, int cy, char c) {
         uint32_t width  = g_fb->framebuffer_width;
         uint32_t height = g_fb->framebuffer_height;
         uint32_t pitch  = g_fb->framebuffer_pitch;
-        uint32_t* buffer = (uint32_t*)(uintptr_t)g_fb->framebuffer_addr;
+        uint32_t* buffer = g_fb_base;
 
         // Convert character coordinates to pixel coordinates
         int px = cx * FONT8X16_WIDTH;
@@ -114,7 +127,7 @@ void video_draw_char(int cx, int cy, char c) {
 void video_scroll_up(void) {
     if (g_use_vga_text) {
         // VGA text mode: copy lines 1-24 to 0-23, clear line 24
-        volatile uint16_t* vga = (volatile uint16_t*)0xB8000;
+        volatile uint16_t* vga = VGA_TEXT_BUFFER;
         for (int y = 0; y < 24; y++) {
             for (int x = 0; x < 80; x++) {
                 vga[y * 80 + x] = vga[(y + 1) * 80 + x];
@@ -132,7 +145,7 @@ void video_scroll_up(void) {
         uint32_t width  = g_fb->framebuffer_width;
         uint32_t height = g_fb->framebuffer_height;
         uint32_t pitch  = g_fb->framebuffer_pitch;
-        uint32_t* buffer = (uint32_t*)(uintptr_t)g_fb->framebuffer_addr;
+        uint32_t* buffer = g_fb_base;
         uint32_t line_height = FONT8X16_HEIGHT;
         uint32_t lines_per_screen = height / line_height;
 
@@ -1,14 +1,22 @@
 #include <stdint.h>
+#include <stdbool.h>
 #include "drivers/console/console.h"
 #include "mem/mmap.h"
+#include "mem/memblock.h"
 #include "mem/pmm.h"
+#include "mem/page.h"
 #include "mem/vmm.h"
 #include "mem/kmalloc.h"
+#include "mem/slab.h"
+#include "mem/vmalloc.h"
+#include "mem/arena.h"
+#include "mem/mempool.h"
 #include "process/task.h"
 #include "process/scheduler.h"
 #include "process/channel.h"
 #include "arch/x86/gdt.h"
 #include "arch/x86/idt.h"
+#include "arch/x86/tsc.h"
 
 #define MB2_MAGIC 0x36d76289
 #define CHANNEL_BURST_MESSAGES (CHANNEL_QUEUE_CAPACITY + 4u)
@@ -22,7 +30,14 @@ static void hlt_loop(void) {
 static void kernel_idle_loop(void) {
     for (;;) {
         scheduler_reap_terminated_tasks();
-        __asm__ __volatile__("sti; hlt");
+
+        // 할 일이 없을 때 zero 풀과 mempool 예비분을 채우고, 둘 다 가득 차 있으면 hlt
+        // (idle 태스크도 선점되므로 여기서 부르는 PMM/mempool 함수는 모두 IRQ-safe여야 함)
+        uint32_t work = pmm_zero_pool_refill(PMM_ZERO_POOL_BATCH);
+        work += mempool_refill_all();
+        if (work == 0) {
+            __asm__ __volatile__("sti; hlt");
+        }
     }
 }
 
@@ -45,6 +60,266 @@ static void console_putu32(uint32_t v) {
     }
 }
 
+static void console_puthex64(uint64_t v) {
+    console_puts("0x");
+    for (int i = 60; i >= 0; i -= 4) {
+        uint8_t nibble = (uint8_t)((v >> i) & 0xFULL);
+        char c = (nibble < 10) ? (char)('0' + nibble) : (char)('a' + (nibble - 10));
+        console_putc(c);
+    }
+}
+
+// GRUB 커널 명령행 (없으면 NULL)
+static const char* mb2_cmdline(void* mbinfo) {
+    uint8_t* p = (uint8_t*)mbinfo + 8;
+
+    while (1) {
+        struct multiboot_tag* tag = (struct multiboot_tag*)p;
+
+        if (tag->type == MB2_TAG_TYPE_END) return 0;
+        if (tag->type == MB2_TAG_TYPE_CMDLINE) return ((struct multiboot_tag_string*)tag)->string;
+
+        p += (tag->size + 7) & ~7u;
+    }
+}
+
+// 공백으로 구분된 명령행에 option 단어가 있는지 확인
+static bool cmdline_has(const char* cmdline, const char* option) {
+    if (!cmdline) return false;
+
+    while (*cmdline) {
+        const char* a = cmdline;
+        const char* b = option;
+        while (*b && *a == *b) {
+            a++;
+            b++;
+        }
+        if (*b == '\0' && (*a == '\0' || *a == ' ')) {
+            return true;
+        }
+
+        while (*cmdline && *cmdline != ' ') cmdline++;
+        while (*cmdline == ' ') cmdline++;
+    }
+
+    return false;
+}
+
+// PAE 테스트: 4GB 위 프레임을 매핑해 읽고 쓰기
+static void vmm_test_high_frame(void) {
+    if (vmm_get_paging_mode() != VMM_PAGING_PAE || pmm_memory_end() <= PMM_LOW_LIMIT) {
+        return;
+    }
+
+    phys_addr_t frame = pmm_alloc_frame();
+    if (frame < PMM_LOW_LIMIT) {
+        console_puts("[VMM] PAE: no free frame above 4GB\n");
+        if (frame) pmm_free_frame(frame);
+        return;
+    }
+
+    void* virt = (void*)(VMM_VMALLOC_START + VMM_PAGE_SIZE);  // vmalloc_init 전이라 비어 있음
+    void* page_dir = vmm_get_current_page_dir();
+    if (vmm_map_phys(page_dir, virt, frame, VMM_WRITABLE)) {
+        volatile uint32_t* words = (volatile uint32_t*)virt;
+        for (uint32_t i = 0; i < VMM_PAGE_SIZE / 4; i++) {
+            words[i] = 0xA5A50000u | i;
+        }
+
+        bool ok = vmm_lookup_phys(page_dir, virt) == frame;
+        for (uint32_t i = 0; i < VMM_PAGE_SIZE / 4 && ok; i++) {
+            ok = words[i] == (0xA5A50000u | i);
+        }
+
+        console_puts("[VMM] PAE: frame ");
+        console_puthex64(frame);
+        console_puts(ok ? " mapped and verified\n" : " verification FAILED\n");
+
+        vmm_unmap_page(page_dir, virt);
+    }
+
+    pmm_free_frame(frame);
+}
+
+// 주소 공간 전환 비용: 커널 절반만 공유하는 주소 공간과 번갈아 CR3를 바꾸고
+// 매번 vmalloc 버퍼(4KB 매핑)의 각 페이지를 한 번씩 읽어 전환 한 번당 사이클을 잼
+// CR4.PGE를 끄면 전환마다 커널 TLB 엔트리도 사라지고, 켜면 전역 엔트리로 남음
+#define TLB_BENCH_PAGES        64u
+#define TLB_BENCH_ROUNDS_SHIFT 8u
+
+static uint32_t tlb_switch_cycles(void* kernel_dir, void* user_dir, volatile uint8_t* buf) {
+    uint64_t start = tsc_read();
+    for (uint32_t round = 0; round < (1u << TLB_BENCH_ROUNDS_SHIFT); round++) {
+        vmm_switch_page_dir((round & 1) ? kernel_dir : user_dir);
+        for (uint32_t i = 0; i < TLB_BENCH_PAGES; i++) {
+            (void)buf[i * VMM_PAGE_SIZE];
+        }
+    }
+    uint64_t cycles = tsc_read() - start;
+    vmm_switch_page_dir(kernel_dir);
+    return (uint32_t)(cycles >> TLB_BENCH_ROUNDS_SHIFT);
+}
+
+static void vmm_tlb_switch_bench(void) {
+    // 주소 공간을 먼저 만들고 버퍼를 나중에 매핑: 커널 절반 PT를 공유하므로 이후 매핑도 보여야 함
+    void* kernel_dir = vmm_get_kernel_page_dir();
+    void* user_dir = vmm_create_page_dir();
+    if (!user_dir) {
+        return;
+    }
+
+    volatile uint8_t* buf = (volatile uint8_t*)vmalloc(TLB_BENCH_PAGES * VMM_PAGE_SIZE);
+    if (!buf) {
+        vmm_destroy_page_dir(user_dir);
+        return;
+    }
+    for (uint32_t i = 0; i < TLB_BENCH_PAGES; i++) {
+        buf[i * VMM_PAGE_SIZE] = (uint8_t)i;
+    }
+
+    // 새 주소 공간: 아래 3GB는 비어 있고 커널 절반(만든 뒤 생긴 매핑 포함)은 그대로 보여야 함
+    bool clean = vmm_lookup_phys(user_dir, (void*)0x100000) == 0 &&
+                 vmm_lookup_phys(kernel_dir, (void*)0x100000) == 0 &&
+                 vmm_lookup_phys(user_dir, (void*)buf) == vmm_lookup_phys(kernel_dir, (void*)buf);
+    console_puts("[VMM] New address space: lower 3GB empty, kernel half shared: ");
+    console_puts(clean ? "OK\n" : "FAILED\n");
+
+    bool had_global = vmm_global_pages_enabled();
+    vmm_set_global_pages(false);
+    uint32_t flat = tlb_switch_cycles(kernel_dir, user_dir, buf);
+    console_puts("[VMM] TLB switch bench (");
+    console_putu32(TLB_BENCH_PAGES);
+    console_puts(" kernel pages): ");
+    console_putu32(flat);
+    console_puts(" cycles/switch without global pages");
+
+    if (vmm_set_global_pages(true)) {
+        uint32_t global = tlb_switch_cycles(kernel_dir, user_dir, buf);
+        console_puts(", ");
+        console_putu32(global);
+        console_puts(" with global pages");
+    }
+    console_puts("\n");
+    vmm_set_global_pages(had_global);
+
+    vmm_destroy_page_dir(user_dir);
+    vfree((void*)buf);
+}
+
+// 작은 객체 크기별로 블록이 실제 차지하는 바이트와 오버헤드(헤더 + 정렬) 출력
+static void kmalloc_overhead_bench(void) {
+    static const uint32_t sizes[] = { 8, 16, 24, 32, 48, 64, 100, 128 };
+    enum { OBJECTS = 16 };
+    void* objs[OBJECTS];
+
+    console_puts("[KMALLOC] Overhead per object (size: bytes/object, overhead)\n");
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t total = 0;
+        uint32_t count = 0;
+        for (uint32_t j = 0; j < OBJECTS; j++) {
+            objs[j] = kmalloc(sizes[i]);
+            if (objs[j]) {
+                total += kmalloc_block_bytes(objs[j]);
+                count++;
+            }
+        }
+        for (uint32_t j = 0; j < OBJECTS; j++) {
+            kfree(objs[j]);
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        uint32_t per_object = total / count;
+        console_puts("[KMALLOC]   ");
+        console_putu32(sizes[i]);
+        console_puts(": ");
+        console_putu32(per_object);
+        console_puts(", ");
+        console_putu32(per_object - sizes[i]);
+        console_puts("\n");
+    }
+}
+
+// arena 테스트: 작은 임시 객체 묶음을 bump 할당하고 mark/reset으로 한꺼번에 반환
+static void arena_test(void) {
+    arena_t* arena = arena_create(0);
+    if (!arena) {
+        console_puts("[ARENA] Failed to create arena\n");
+        return;
+    }
+
+    bool ok = true;
+    for (uint32_t i = 0; i < 512; i++) {
+        uint32_t* obj = (uint32_t*)arena_alloc(arena, 24);
+        if (!obj || ((uint32_t)obj & (ARENA_ALIGN - 1)) != 0) {
+            ok = false;
+            break;
+        }
+        obj[0] = i;
+    }
+    console_puts("[ARENA] 512 x 24B: ");
+    console_putu32(arena_used_bytes(arena));
+    console_puts(" bytes in ");
+    console_putu32(arena_chunk_count(arena));
+    console_puts(ok ? " chunks, OK\n" : " chunks, FAIL\n");
+
+    // 중첩 구간: mark 이후 할당만 되돌아가야 함
+    arena_mark_t mark = arena_mark(arena);
+    uint32_t used = arena_used_bytes(arena);
+    void* page = arena_alloc_aligned(arena, 8192, PAGE_SIZE);
+    arena_t* child = arena_create_nested(arena, 0);
+    void* child_obj = arena_alloc(child, 100);
+    arena_release(arena, mark);
+    console_puts("[ARENA] Nested scope: ");
+    console_puts(page && ((uint32_t)page & (PAGE_SIZE - 1)) == 0 && child_obj &&
+                 arena_used_bytes(arena) == used ? "released OK\n" : "FAIL\n");
+
+    uint32_t pages_before = arena_total_pages();
+    arena_reset(arena);
+    console_puts("[ARENA] After reset: ");
+    console_putu32(arena_used_bytes(arena));
+    console_puts(" bytes, ");
+    console_putu32(pages_before - arena_total_pages());
+    console_puts(" pages returned to PMM\n");
+    arena_destroy(arena);
+}
+
+// mempool 테스트: 예비분만으로 할당하고, 비면 NULL, refill로 다시 채움
+static void mempool_test(void) {
+    enum { RESERVE = 8 };
+    void* elems[RESERVE + 1];
+
+    mempool_t* pool = mempool_create("test_pool", 32, RESERVE);
+    if (!pool) {
+        console_puts("[MEMPOOL] Failed to create pool\n");
+        return;
+    }
+
+    for (uint32_t i = 0; i <= RESERVE; i++) {
+        elems[i] = mempool_alloc(pool);
+    }
+    console_puts("[MEMPOOL] Drained ");
+    console_putu32(mempool_in_use(pool));
+    console_puts(" elements, next alloc ");
+    console_puts(elems[RESERVE] ? "FAIL (not empty)\n" : "returned NULL\n");
+
+    for (uint32_t i = 0; i < RESERVE; i++) {
+        mempool_free(pool, elems[i]);
+    }
+    void* held = mempool_alloc(pool);
+    uint32_t refilled = mempool_refill(pool);
+    console_puts("[MEMPOOL] Refill added ");
+    console_putu32(refilled);
+    console_puts(", available ");
+    console_putu32(mempool_available(pool));
+    console_puts("\n");
+    // 나가 있는 원소가 돌아와야 destroy 가능 (넘친 예비분은 refill이 slab에 반환)
+    mempool_free(pool, held);
+    mempool_refill(pool);
+    mempool_destroy(pool);
+}
+
 static uint32_t current_task_pid(void) {
     task_struct_t* current = task_get_current();
     return current ? current->pid : 0;
@@ -100,6 +375,19 @@ static void channel_consumer_b_task(void) {
     channel_consumer_loop('b');
 }
 
+// 짧게 살다 끝나는 태스크: task_alloc으로 받은 버퍼는 reap 때 한꺼번에 반환됨
+static void arena_worker_task(void) {
+    for (uint32_t i = 0; i < 16; i++) {
+        uint8_t* buf = (uint8_t*)task_alloc(0, 64 + i * 16);
+        if (!buf) {
+            console_putc('!');
+            break;
+        }
+        buf[0] = (uint8_t)i;
+    }
+    console_putc('T');
+}
+
 static void channel_heartbeat_task(void) {
     for (;;) {
         console_putc('.');
@@ -111,6 +399,9 @@ void kernel_main(uint32_t magic, void* mbinfo) {
     if (magic != MB2_MAGIC)
         hlt_loop();
 
+    // 부팅 트램펄린이 넘긴 물리 주소를 higher-half에서 보이는 physmap 주소로
+    mbinfo = vmm_phys_to_virt((uintptr_t)mbinfo);
+
     // Initialize console first (needed for GDT verification output)
     console_init(mbinfo);
     console_clear();
@@ -121,11 +412,24 @@ void kernel_main(uint32_t magic, void* mbinfo) {
     // Initialize IDT
     idt_init();
 
+    // Calibrate TSC (boot-time measurements)
+    tsc_init();
+
 	mmap_dump(magic, mbinfo);
     
+    // paging=legacy / paging=pae 로 페이징 모드를 강제할 수 있음 (기본: 자동)
+    // PMM이 4GB 위 메모리를 관리할지 정하므로 pmm_init 전에 설정
+    const char* cmdline = mb2_cmdline(mbinfo);
+    if (cmdline_has(cmdline, "paging=legacy")) {
+        vmm_set_paging_mode(VMM_PAGING_LEGACY);
+    } else if (cmdline_has(cmdline, "paging=pae")) {
+        vmm_set_paging_mode(VMM_PAGING_PAE);
+    }
+
     // Initialize PMM
     console_puts("\n[PMM] Initializing...\n");
-    pmm_init(magic, mbinfo);
+    memblock_init(magic, mbinfo);
+    pmm_init();
     
     // Test: Allocate and free pages
     console_puts("[PMM] Testing page allocation...\n");
@@ -150,36 +454,91 @@ void kernel_main(uint32_t magic, void* mbinfo) {
     } else {
         console_puts("[PMM] Failed to allocate pages\n");
     }
-    
+
+    // Test: 프레임 디스크립터 참조 카운트 (공유 프레임은 마지막 참조에서 반환)
+    void* shared = pmm_alloc_page();
+    if (shared) {
+        page_t* desc = virt_to_page(shared);
+        page_get(desc);
+        bool kept = pmm_free_page(shared) && !page_is_free(desc);
+        bool released = pmm_free_page(shared) && page_is_free(desc);
+        bool double_free = pmm_free_page(shared);
+        console_puts((kept && released && !double_free)
+                         ? "[PMM] Shared frame released on last reference\n"
+                         : "[PMM] Frame refcount test FAILED\n");
+    }
+
+    // Test: zone 지정 할당 (장치 버퍼용 DMA zone)
+    void* dma_page = pmm_alloc_page_flags(PMM_ZONE_DMA);
+    if (dma_page && vmm_virt_to_phys(dma_page) < PMM_DMA_LIMIT) {
+        console_puts("[PMM] DMA zone allocation below 16MB OK, DMA free: ");
+        console_putu32(pmm_zone_free_pages(PMM_ZONE_ID_DMA));
+        console_puts(" pages\n");
+    } else {
+        console_puts("[PMM] DMA zone allocation failed\n");
+    }
+    pmm_free_page(dma_page);
+
+    // Test: DMA zone은 1MB에서 시작해도 order 블록은 물리 주소로 정렬되어야 함 (2MB 블록)
+    void* dma_block = pmm_alloc_order_flags(9, PMM_ZONE_DMA);
+    if (dma_block && (vmm_virt_to_phys(dma_block) & ((PAGE_SIZE << 9) - 1)) == 0) {
+        console_puts("[PMM] DMA order-9 block physically aligned OK\n");
+    } else {
+        console_puts("[PMM] DMA order-9 block alignment FAILED\n");
+    }
+    if (dma_block) {
+        pmm_free_order(dma_block, 9);
+    }
+
     // Initialize VMM
     console_puts("\n[VMM] Initializing Virtual Memory Manager...\n");
     vmm_init();
     
     // Test: VMM 페이지 매핑
     console_puts("[VMM] Testing page mapping...\n");
-    void* test_phys = pmm_alloc_page();
-    if (test_phys) {
-        void* test_virt = (void*)0xC0000000; // 높은 가상 주소에 매핑
+    void* test_page = pmm_alloc_page();
+    if (test_page) {
+        void* test_phys = (void*)(uintptr_t)vmm_virt_to_phys(test_page);
+        void* test_virt = (void*)VMM_VMALLOC_START; // 높은 가상 주소에 매핑 (vmalloc_init 전이라 비어 있음)
         if (vmm_map_page(vmm_get_current_page_dir(), test_virt, test_phys, VMM_WRITABLE)) {
-            console_puts("[VMM] Successfully mapped virtual address 0xC0000000\n");
+            console_puts("[VMM] Successfully mapped virtual address 0xF0000000\n");
             
             // 물리 주소 확인
             void* mapped_phys = vmm_get_phys_addr(vmm_get_current_page_dir(), test_virt);
             if (mapped_phys == test_phys) {
                 console_puts("[VMM] Physical address lookup successful\n");
             }
+
+            // physmap: 같은 프레임이 PMM 포인터(physmap 주소)에서도 보여야 함
+            volatile uint32_t* mapped = (volatile uint32_t*)test_virt;
+            volatile uint32_t* linear = (volatile uint32_t*)test_page;
+            mapped[0] = 0x5A5AC3C3;
+            console_puts("[VMM] Physmap alias ");
+            console_puts(linear[0] == 0x5A5AC3C3 && vmm_phys_to_virt((uintptr_t)test_phys) == test_page
+                             ? "OK\n" : "FAILED\n");
             
             // 언매핑
             if (vmm_unmap_page(vmm_get_current_page_dir(), test_virt)) {
                 console_puts("[VMM] Successfully unmapped page\n");
             }
         }
-        pmm_free_page(test_phys);
+        pmm_free_page(test_page);
     }
+    vmm_test_high_frame();
     
+    // Initialize SLAB (task/channel 등 고정 크기 객체 캐시)
+    console_puts("\n[SLAB] Initializing object caches...\n");
+    kmem_cache_init();
+
     // Initialize KMALLOC
     console_puts("\n[KMALLOC] Initializing kernel heap...\n");
     kmalloc_init();
+
+    // kmalloc_profile: 호출 위치별 힙 사용량 기록 (부팅 테스트 뒤에 결과 출력)
+    if (cmdline_has(cmdline, "kmalloc_profile")) {
+        kmalloc_profile_enable(true);
+        console_puts("[KMALLOC] Allocation profiling enabled\n");
+    }
     
     // Test: kmalloc and kfree
     console_puts("[KMALLOC] Testing memory allocation...\n");
@@ -285,7 +644,98 @@ void kernel_main(uint32_t magic, void* mbinfo) {
         console_putu32(kmalloc_free_bytes());
         console_puts(" bytes\n");
     }
+
+    // 정렬 할당 테스트
+    void* aligned_block = kmalloc_aligned(100, 256);
+    void* page_block = kmalloc_pages(2);
+    if (aligned_block && page_block) {
+        console_puts("[KMALLOC] Aligned allocation: 256B ");
+        console_puts(((uint32_t)aligned_block & 0xFF) == 0 ? "OK" : "FAIL");
+        console_puts(", 2 pages ");
+        console_puts(((uint32_t)page_block & 0xFFF) == 0 ? "OK\n" : "FAIL\n");
+    }
+    kfree(aligned_block);
+    kfree(page_block);
+
+    // krealloc 테스트: 뒤쪽이 비어 있으면 같은 주소에서 늘어나야 함
+    uint32_t* grow = (uint32_t*)kmalloc(64);
+    if (grow) {
+        for (uint32_t i = 0; i < 16; i++) {
+            grow[i] = i;
+        }
+        uint32_t* grown = (uint32_t*)krealloc(grow, 1024);
+        if (grown) {
+            bool kept = true;
+            for (uint32_t i = 0; i < 16; i++) {
+                if (grown[i] != i) {
+                    kept = false;
+                }
+            }
+            console_puts("[KMALLOC] krealloc 64 -> 1024: ");
+            console_puts(grown == grow ? "in place" : "moved");
+            console_puts(kept ? ", data kept\n" : ", data LOST\n");
+            kfree(grown);
+        }
+    }
+
+    kmalloc_overhead_bench();
+
+    if (kmalloc_profile_enabled()) {
+        kmalloc_profile_dump();
+    }
+
+    // 축소 테스트: 큰 블록을 해제하면 그 페이지가 PMM으로 돌아가야 함
+    console_puts("\n[KMALLOC] Testing heap shrink...\n");
+    void* burst = kmalloc(256 * 1024);
+    if (burst) {
+        console_puts("[KMALLOC] Heap after 256KB burst: ");
+        console_putu32(kmalloc_total_bytes());
+        console_puts(" bytes\n");
+        kfree(burst);
+        console_puts("[KMALLOC] Heap after free: ");
+        console_putu32(kmalloc_total_bytes());
+        console_puts(" bytes (");
+        console_putu32(kmalloc_pages_released());
+        console_puts(" pages returned to PMM)\n");
+    }
     
+    // Initialize VMALLOC
+    console_puts("\n[VMALLOC] Initializing vmalloc area...\n");
+    vmalloc_init();
+
+    // Test: 256KB 버퍼 (물리적으로 연속일 필요 없음)
+    uint32_t* vbuf = (uint32_t*)vmalloc(256 * 1024);
+    if (vbuf) {
+        uint32_t words = (256 * 1024) / sizeof(uint32_t);
+        for (uint32_t i = 0; i < words; i++) {
+            vbuf[i] = i ^ 0xA5A5A5A5;
+        }
+        bool vbuf_ok = true;
+        for (uint32_t i = 0; i < words; i++) {
+            if (vbuf[i] != (i ^ 0xA5A5A5A5)) {
+                vbuf_ok = false;
+                break;
+            }
+        }
+        console_puts("[VMALLOC] 256KB buffer: ");
+        console_putu32(vmalloc_used_pages());
+        console_puts(" pages mapped, ");
+        console_puts(vbuf_ok ? "data OK\n" : "data MISMATCH\n");
+        if (vfree(vbuf)) {
+            console_puts("[VMALLOC] Freed buffer, mapped pages: ");
+            console_putu32(vmalloc_used_pages());
+            console_puts("\n");
+        }
+    }
+
+    vmm_tlb_switch_bench();
+
+    console_puts("\n[ARENA] Testing region allocator...\n");
+    arena_test();
+
+    console_puts("\n[MEMPOOL] Testing emergency reserves...\n");
+    mempool_test();
+
     // Initialize Task Management
     console_puts("\n[TASK] Initializing task management...\n");
     task_init();
@@ -333,11 +783,23 @@ void kernel_main(uint32_t magic, void* mbinfo) {
         scheduler_add_task(consumer_a);
         scheduler_add_task(consumer_b);
         scheduler_add_task(heartbeat);
+
+        task_struct_t* worker = task_create("worker", arena_worker_task, 1);
+        if (worker) {
+            scheduler_add_task(worker);
+        }
         
         // 스케줄러 상태 출력
         console_puts("\n");
         scheduler_print_status();
         
+        console_puts("\n[PMM] Zero pool: ");
+        console_putu32(pmm_zero_pool_hits());
+        console_puts(" hits, ");
+        console_putu32(pmm_zero_pool_misses());
+        console_puts(" misses (refilled by idle loop)\n");
+        kmem_cache_print_stats();
+
         console_puts("\n[SCHEDULER] Tasks are ready. Enabling timer IRQ0...\n");
         console_puts("[CHANNEL] Output should show send(S), wait(W), consumer(a/b), and heartbeat(.).\n");
 
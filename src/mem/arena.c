@@ -0,0 +1,294 @@
+#include "mem/arena.h"
+#include "mem/pmm.h"
+#include "mem/kmalloc.h"
+#include "drivers/console/console.h"
+#include "arch/x86/irqflags.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// chunk 배치:
+//   [arena_chunk_t][arena_t (첫 chunk만)][객체 ...                    ][남은 공간]
+//                                       ^base                 cur^       end^
+// 새 chunk는 리스트 머리에 붙고 prev로 먼저 붙은 chunk를 가리킴
+// 첫 chunk는 arena 구조체를 품고 있으므로 arena_destroy 때 마지막으로 반환
+
+#define ARENA_NESTED_ORDER   0xFFFFFFFFu    // parent arena에서 받은 chunk
+#define ARENA_HEAP_ORDER     0xFFFFFFFEu    // kmalloc에서 받은 chunk
+#define ARENA_NESTED_DEFAULT 512u           // 중첩 arena의 기본 chunk 크기 (바이트)
+#define ARENA_HEAP_DEFAULT   2048u          // 힙 arena의 기본 chunk 크기 (바이트)
+#define ARENA_MAX_CHUNK      (PAGE_SIZE << PMM_MAX_ORDER)
+
+typedef struct arena_chunk {
+    struct arena_chunk* prev;   // 먼저 붙은 chunk (첫 chunk면 NULL)
+    uint8_t* end;               // chunk 끝 (다음 바이트)
+    uint32_t order;             // PMM 블록 order, 아니면 ARENA_NESTED_ORDER / ARENA_HEAP_ORDER
+    uint32_t reserved;
+} arena_chunk_t;
+
+struct arena {
+    arena_chunk_t* chunk;       // 현재 (가장 최근) chunk
+    uint8_t* cur;               // 다음 할당 위치
+    uint8_t* base;              // 첫 chunk에서 객체가 시작하는 위치 (reset 지점)
+    arena_t* parent;            // 중첩 arena면 chunk를 받는 parent
+    bool from_heap;             // chunk를 kmalloc에서 받음
+    uint32_t chunk_bytes;       // 기본 chunk 크기
+    uint32_t chunks;
+    uint32_t used;
+};
+
+static uint32_t total_pages = 0;
+
+static inline uintptr_t arena_align_up(uintptr_t value, uintptr_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+static inline uint8_t* arena_chunk_data(arena_chunk_t* chunk) {
+    return (uint8_t*)(chunk + 1);
+}
+
+static inline arena_chunk_t* arena_first_chunk(const arena_t* arena) {
+    return (arena_chunk_t*)arena - 1;
+}
+
+// bytes 이상을 담는 가장 작은 2^order 페이지
+static uint32_t arena_order_for(uint32_t bytes) {
+    uint32_t order = 0;
+    while ((PAGE_SIZE << order) < bytes) {
+        order++;
+    }
+    return order;
+}
+
+// bytes(헤더 포함) 이상인 chunk 하나 (parent > 힙 > PMM 순서로 출처 결정)
+static arena_chunk_t* arena_chunk_alloc(arena_t* parent, bool from_heap, uint32_t bytes) {
+    arena_chunk_t* chunk;
+
+    if (parent) {
+        chunk = (arena_chunk_t*)arena_alloc(parent, bytes);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->order = ARENA_NESTED_ORDER;
+        chunk->end = (uint8_t*)chunk + bytes;
+    } else if (from_heap) {
+        chunk = (arena_chunk_t*)kmalloc(bytes);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->order = ARENA_HEAP_ORDER;
+        chunk->end = (uint8_t*)chunk + bytes;
+    } else {
+        if (bytes > ARENA_MAX_CHUNK) {
+            return NULL;
+        }
+        // PMM은 안에서 irq_save로 막으므로 여러 태스크의 arena가 동시에 불러도 됨
+        uint32_t order = arena_order_for(bytes);
+        chunk = (arena_chunk_t*)pmm_alloc_order(order);
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->order = order;
+        chunk->end = (uint8_t*)chunk + (PAGE_SIZE << order);
+        uint32_t irq = irq_save();
+        total_pages += 1u << order;
+        irq_restore(irq);
+    }
+
+    chunk->prev = NULL;
+    chunk->reserved = 0;
+    return chunk;
+}
+
+// 중첩 chunk는 parent가 reset/destroy될 때 같이 반환되므로 여기서는 버림
+static void arena_chunk_free(arena_chunk_t* chunk) {
+    if (chunk->order == ARENA_NESTED_ORDER) {
+        return;
+    }
+    if (chunk->order == ARENA_HEAP_ORDER) {
+        kfree(chunk);
+        return;
+    }
+    uint32_t irq = irq_save();
+    total_pages -= 1u << chunk->order;
+    irq_restore(irq);
+    pmm_free_order(chunk, chunk->order);
+}
+
+static arena_t* arena_create_from(arena_t* parent, bool from_heap, size_t chunk_size) {
+    uint32_t header = sizeof(arena_chunk_t) + (uint32_t)arena_align_up(sizeof(arena_t), ARENA_ALIGN);
+    uint32_t chunk_bytes;
+
+    if (chunk_size > ARENA_MAX_CHUNK) {
+        return NULL;
+    }
+    if (parent) {
+        chunk_bytes = chunk_size ? (uint32_t)arena_align_up(chunk_size, ARENA_ALIGN) : ARENA_NESTED_DEFAULT;
+    } else if (from_heap) {
+        chunk_bytes = chunk_size ? (uint32_t)arena_align_up(chunk_size, ARENA_ALIGN) : ARENA_HEAP_DEFAULT;
+    } else {
+        chunk_bytes = PAGE_SIZE << arena_order_for(chunk_size ? (uint32_t)chunk_size : PAGE_SIZE);
+    }
+
+    arena_chunk_t* first = arena_chunk_alloc(parent, from_heap, chunk_bytes > header ? chunk_bytes : header + ARENA_ALIGN);
+    if (!first) {
+        return NULL;
+    }
+
+    arena_t* arena = (arena_t*)arena_chunk_data(first);
+    arena->chunk = first;
+    arena->base = (uint8_t*)first + header;
+    arena->cur = arena->base;
+    arena->parent = parent;
+    arena->from_heap = from_heap;
+    arena->chunk_bytes = chunk_bytes;
+    arena->chunks = 1;
+    arena->used = 0;
+    return arena;
+}
+
+arena_t* arena_create(size_t chunk_size) {
+    return arena_create_from(NULL, false, chunk_size);
+}
+
+arena_t* arena_create_heap(size_t chunk_size) {
+    return arena_create_from(NULL, true, chunk_size);
+}
+
+arena_t* arena_create_nested(arena_t* parent, size_t chunk_size) {
+    if (!parent) {
+        return NULL;
+    }
+    return arena_create_from(parent, false, chunk_size);
+}
+
+// 현재 chunk의 남은 공간은 버리고 need 바이트 이상 들어가는 chunk를 새로 붙임
+static bool arena_grow(arena_t* arena, uint32_t need) {
+    uint32_t bytes = sizeof(arena_chunk_t) + need;
+    if (bytes < need) {
+        return false;
+    }
+    if (bytes < arena->chunk_bytes) {
+        bytes = arena->chunk_bytes;
+    }
+
+    arena_chunk_t* chunk = arena_chunk_alloc(arena->parent, arena->from_heap, bytes);
+    if (!chunk) {
+        return false;
+    }
+
+    chunk->prev = arena->chunk;
+    arena->chunk = chunk;
+    arena->cur = arena_chunk_data(chunk);
+    arena->chunks++;
+    return true;
+}
+
+void* arena_alloc_aligned(arena_t* arena, size_t size, size_t align) {
+    if (!arena || size == 0 || size > ARENA_MAX_CHUNK) {
+        return NULL;
+    }
+    if (align < ARENA_ALIGN) {
+        align = ARENA_ALIGN;
+    }
+    if ((align & (align - 1)) != 0 || align > PAGE_SIZE) {
+        return NULL;
+    }
+
+    // cur는 항상 ARENA_ALIGN 정렬 상태로 유지
+    size = arena_align_up(size, ARENA_ALIGN);
+
+    uintptr_t addr = arena_align_up((uintptr_t)arena->cur, align);
+    uintptr_t end = (uintptr_t)arena->chunk->end;
+    if (addr > end || size > end - addr) {
+        if (!arena_grow(arena, (uint32_t)(size + align - ARENA_ALIGN))) {
+            return NULL;
+        }
+        addr = arena_align_up((uintptr_t)arena->cur, align);
+    }
+
+    arena->used += (uint32_t)(addr + size - (uintptr_t)arena->cur);
+    arena->cur = (uint8_t*)(addr + size);
+    return (void*)addr;
+}
+
+void* arena_alloc(arena_t* arena, size_t size) {
+    return arena_alloc_aligned(arena, size, ARENA_ALIGN);
+}
+
+void arena_reset(arena_t* arena) {
+    if (!arena) {
+        return;
+    }
+
+    arena_chunk_t* first = arena_first_chunk(arena);
+    while (arena->chunk != first) {
+        arena_chunk_t* prev = arena->chunk->prev;
+        arena_chunk_free(arena->chunk);
+        arena->chunk = prev;
+    }
+
+    arena->cur = arena->base;
+    arena->chunks = 1;
+    arena->used = 0;
+}
+
+void arena_destroy(arena_t* arena) {
+    if (!arena) {
+        return;
+    }
+
+    arena_reset(arena);
+    arena_chunk_free(arena_first_chunk(arena));
+}
+
+arena_mark_t arena_mark(arena_t* arena) {
+    arena_mark_t mark = { NULL, NULL, 0 };
+    if (arena) {
+        mark.chunk = arena->chunk;
+        mark.cur = arena->cur;
+        mark.used = arena->used;
+    }
+    return mark;
+}
+
+void arena_release(arena_t* arena, arena_mark_t mark) {
+    if (!arena || !mark.chunk) {
+        return;
+    }
+
+    // mark가 이 arena의 chunk를 가리키는지 먼저 확인 (이미 release된 mark면 거부)
+    arena_chunk_t* target = (arena_chunk_t*)mark.chunk;
+    arena_chunk_t* chunk = arena->chunk;
+    uint32_t released = 0;
+    while (chunk && chunk != target) {
+        chunk = chunk->prev;
+        released++;
+    }
+    if (!chunk || mark.cur < arena_chunk_data(target) || mark.cur > target->end ||
+        (chunk == arena->chunk && mark.cur > arena->cur)) {
+        console_puts("[ARENA] arena_release: stale or foreign mark\n");
+        return;
+    }
+
+    while (arena->chunk != target) {
+        arena_chunk_t* prev = arena->chunk->prev;
+        arena_chunk_free(arena->chunk);
+        arena->chunk = prev;
+    }
+    arena->chunks -= released;
+    arena->cur = mark.cur;
+    arena->used = mark.used;
+}
+
+uint32_t arena_used_bytes(const arena_t* arena) {
+    return arena ? arena->used : 0;
+}
+
+uint32_t arena_chunk_count(const arena_t* arena) {
+    return arena ? arena->chunks : 0;
+}
+
+uint32_t arena_total_pages(void) {
+    return total_pages;
+}
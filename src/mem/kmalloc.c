@@ -1,248 +1,1115 @@
 #include "mem/kmalloc.h"
 #include "mem/pmm.h"
+#include "mem/vmm.h"
+#include "arch/x86/irqflags.h"
 #include "drivers/console/console.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
 
-// 블록 헤더 구조체
+// TLSF (Two-Level Segregated Fit) 힙
+// free 블록을 크기 클래스별 리스트에 두고, 1단계(2의 거듭제곱 범위) /
+// 2단계(그 범위를 16등분) 비트맵으로 비어 있지 않은 리스트를 찾음
+// -> 할당/해제 모두 블록 수와 무관한 O(1)
+//
+// 힙은 커널 가상 영역 [VMM_KHEAP_START, VMM_KHEAP_END)에 있는 하나의 연속 arena
+// 프레임을 한 장씩 매핑해 늘리므로 연속된 물리 페이지가 필요 없음
+// arena 끝에는 크기 0의 사용 중 sentinel 블록을 두어 매핑 안 된 영역을 넘지 않게 함
+//
+// 블록 형식 (boundary tag)
+//   사용 중: [크기|플래그] [데이터 ...]
+//   free   : [크기|플래그] [next_free] [prev_free] ... [footer = 크기]
+// 사용 중 블록에는 헤더 한 워드만 붙고, free 리스트 포인터와 footer는 free 블록의
+// 데이터 영역 안에 들어감 -> 작은 객체 오버헤드가 i386에서 8바이트 이하
+// 앞 블록이 free인지는 헤더의 PREV_FREE 비트로 알고, 그때만 바로 앞 워드(footer)로
+// 앞 블록 헤더를 찾아 병합
+
+// 블록 헤더 구조체 (next_free/prev_free는 free 블록에서만 유효)
 typedef struct block_header {
-    size_t size;                    // 블록 크기 (헤더 제외, 사용자가 사용 가능한 크기)
-    bool is_free;                   // 할당 여부
-    struct block_header* next;      // 다음 블록
-    struct block_header* prev;      // 이전 블록
-    uint32_t magic;                 // 매직 넘버 (오버플로우 감지)
+    size_t size;                        // 블록 전체 크기 (헤더 포함, ALIGN_SIZE 배수) | BLOCK_FLAG_*
+    struct block_header* next_free;     // 같은 크기 클래스의 free 리스트
+    struct block_header* prev_free;
 } block_header_t;
 
-#define BLOCK_MAGIC 0xDEADBEEF
-#define HEADER_SIZE sizeof(block_header_t)
-#define ALIGN_SIZE 16
-#define MIN_BLOCK_SIZE 32
+#define BLOCK_FLAG_FREE      0x1u   // 할당 여부
+#define BLOCK_FLAG_PREV_FREE 0x2u   // 바로 앞 블록이 free (바로 앞 워드가 그 footer)
+#define BLOCK_FLAG_HOLES     0x4u   // free 블록 안에 PMM에 반환된(언매핑된) 페이지가 있을 수 있음
+#define BLOCK_FLAG_MASK      0x7u
+
+// 커널은 SSE를 쓰지 않으므로 8바이트 정렬이면 충분
+#define ALIGN_SIZE 8
+#define ALIGN_SIZE_LOG2 3
+#define HEADER_SIZE sizeof(size_t)
+#define FOOTER_SIZE sizeof(size_t)
+// free 블록이 담아야 하는 것: 헤더 + 리스트 포인터 2개 + footer
+#define MIN_BLOCK_SIZE ((sizeof(block_header_t) + FOOTER_SIZE + ALIGN_SIZE - 1) & ~(size_t)(ALIGN_SIZE - 1))
+// 데이터가 ALIGN_SIZE에 맞도록 첫 블록을 arena 시작에서 밀어 둠 (i386: 4바이트)
+#define HEAP_FIRST_BLOCK (VMM_KHEAP_START + (ALIGN_SIZE - HEADER_SIZE % ALIGN_SIZE) % ALIGN_SIZE)
+
+// 2단계 클래스 수 = 2^4 = 16
+#define SL_INDEX_COUNT_LOG2 4
+#define SL_INDEX_COUNT (1u << SL_INDEX_COUNT_LOG2)
+// 128B 미만은 8B 간격의 선형 클래스 (1단계 인덱스 0)
+#define FL_INDEX_SHIFT (SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2)
+#define SMALL_BLOCK_SIZE (1u << FL_INDEX_SHIFT)
+// 최대 블록 크기 2^28 (256MB)
+#define FL_INDEX_MAX 28
+#define FL_INDEX_COUNT (FL_INDEX_MAX - FL_INDEX_SHIFT + 1)
+#define BLOCK_SIZE_MAX ((size_t)1 << FL_INDEX_MAX)
+
+// TLSF 제어 구조
+static uint32_t fl_bitmap = 0;
+static uint32_t sl_bitmap[FL_INDEX_COUNT];
+static block_header_t* free_lists[FL_INDEX_COUNT][SL_INDEX_COUNT];
 
 // 힙 관리 변수
-static block_header_t* heap_start = NULL;
-static block_header_t* heap_end = NULL;
+static uintptr_t heap_brk = VMM_KHEAP_START;   // arena에서 매핑된 영역의 끝
 static uint32_t total_heap_size = 0;  // 전체 힙 크기 (헤더 포함)
 static uint32_t used_bytes = 0;       // 할당된 데이터 크기 (헤더 제외)
-static uint32_t free_bytes = 0;       // 사용 가능한 데이터 크기 (헤더 제외)
+static uint32_t free_bytes = 0;       // free 블록 데이터 크기 (헤더 제외, 구멍 페이지 포함)
+
+// 힙 축소: 이 크기 이상인 free 블록이 생기면 그 안의 온전한 페이지를 PMM에 반환
+// 작은 free 블록까지 반환하면 할당/해제가 반복될 때 매핑/언매핑이 계속 일어나므로
+// 임계값이 hysteresis 역할을 함 (0이면 축소 안 함)
+static uint32_t shrink_threshold = KMALLOC_SHRINK_THRESHOLD_DEFAULT;
+static uint32_t pages_released = 0;   // PMM에 반환한 누적 페이지 수
+
+// 할당 프로파일러 (kmalloc_profile_enable로 켬)
+// 살아 있는 블록마다 (주소 -> 호출 위치, 요청 크기)를 고정 크기 해시 표에 기록하고
+// 호출 위치별 live 바이트/개수와 2의 거듭제곱 크기 히스토그램을 유지
+// 꺼져 있고 기록된 블록도 없으면 할당/해제 경로의 추가 비용은 분기 하나
+#define PROFILE_SITE_COUNT 64u          // 0번은 표가 가득 찼을 때 쓰는 "기타"
+#define PROFILE_TRACK_BITS 12u
+#define PROFILE_TRACK_COUNT (1u << PROFILE_TRACK_BITS)
+#define PROFILE_HIST_BINS (FL_INDEX_MAX + 1)
+
+typedef struct profile_site {
+    uintptr_t addr;         // 호출 위치 (kmalloc 등의 반환 주소)
+    uint32_t live_bytes;
+    uint32_t live_count;
+    uint32_t total_count;
+    uint32_t peak_bytes;
+} profile_site_t;
+
+typedef struct profile_entry {
+    uintptr_t ptr;          // 0이면 빈 칸
+    uint32_t size;          // 요청 크기
+    uint32_t site;
+} profile_entry_t;
+
+static bool profile_enabled = false;
+static uint32_t profile_tracked = 0;    // 표에 있는 살아 있는 블록 수
+static uint32_t profile_dropped = 0;    // 표가 가득 차 기록하지 못한 할당 수
+static profile_site_t profile_sites[PROFILE_SITE_COUNT];
+static profile_entry_t profile_table[PROFILE_TRACK_COUNT];
+static uint32_t profile_hist_total[PROFILE_HIST_BINS];
+static uint32_t profile_hist_live[PROFILE_HIST_BINS];
+
+static void console_putu32(uint32_t value) {
+    char buf[11];
+    int idx = 0;
+    if (value == 0) {
+        console_putc('0');
+        return;
+    }
+    while (value > 0 && idx < 10) {
+        buf[idx++] = (char)('0' + (value % 10));
+        value /= 10;
+    }
+    while (idx--) console_putc(buf[idx]);
+}
+
+static void console_puthex(uintptr_t value) {
+    console_puts("0x");
+    for (int shift = (int)sizeof(uintptr_t) * 8 - 4; shift >= 0; shift -= 4) {
+        uint8_t nibble = (uint8_t)((value >> shift) & 0xF);
+        console_putc(nibble < 10 ? (char)('0' + nibble) : (char)('a' + (nibble - 10)));
+    }
+}
 
 // 크기를 정렬
 static inline size_t align_size(size_t size) {
-    return (size + ALIGN_SIZE - 1) & ~(ALIGN_SIZE - 1);
+    return (size + ALIGN_SIZE - 1) & ~(size_t)(ALIGN_SIZE - 1);
+}
+
+// 요청 크기 -> 블록 전체 크기 (헤더 포함, free가 되어도 담을 수 있게 최소 크기 이상)
+static inline size_t adjust_request(size_t size) {
+    size = align_size(size + HEADER_SIZE);
+    return size < MIN_BLOCK_SIZE ? MIN_BLOCK_SIZE : size;
+}
+
+// 가장 높은 / 낮은 set 비트 (bsr / bsf)
+static inline int tlsf_fls(uint32_t word) {
+    return word ? 31 - __builtin_clz(word) : -1;
+}
+
+static inline int tlsf_ffs(uint32_t word) {
+    return word ? __builtin_ctz(word) : -1;
+}
+
+static inline size_t block_size(const block_header_t* block) {
+    return block->size & ~(size_t)BLOCK_FLAG_MASK;
+}
+
+static inline bool block_test(const block_header_t* block, size_t flag) {
+    return (block->size & flag) != 0;
+}
+
+static inline void block_set(block_header_t* block, size_t flag) {
+    block->size |= flag;
+}
+
+static inline void block_clear(block_header_t* block, size_t flag) {
+    block->size &= ~flag;
+}
+
+// 플래그는 그대로 두고 크기만 변경
+static inline void block_set_size(block_header_t* block, size_t size) {
+    block->size = size | (block->size & BLOCK_FLAG_MASK);
+}
+
+static inline void* block_to_ptr(block_header_t* block) {
+    return (uint8_t*)block + HEADER_SIZE;
+}
+
+static inline block_header_t* ptr_to_block(void* ptr) {
+    return (block_header_t*)((uint8_t*)ptr - HEADER_SIZE);
+}
+
+static inline block_header_t* block_next_phys(block_header_t* block) {
+    return (block_header_t*)((uint8_t*)block + block_size(block));
+}
+
+// 바로 앞 블록 (PREV_FREE일 때만 유효: 바로 앞 워드가 앞 블록의 footer)
+static inline block_header_t* block_prev_phys(block_header_t* block) {
+    return (block_header_t*)((uint8_t*)block - *((size_t*)block - 1));
+}
+
+// free로 표시: footer를 쓰고 다음 블록에 PREV_FREE 표시
+static void block_mark_free(block_header_t* block) {
+    block_set(block, BLOCK_FLAG_FREE);
+    block_header_t* next = block_next_phys(block);
+    *((size_t*)next - 1) = block_size(block);
+    block_set(next, BLOCK_FLAG_PREV_FREE);
+}
+
+// 사용 중으로 표시 (footer 자리는 다시 데이터 영역이 됨)
+static void block_mark_used(block_header_t* block) {
+    block_clear(block, BLOCK_FLAG_FREE | BLOCK_FLAG_HOLES);
+    block_clear(block_next_phys(block), BLOCK_FLAG_PREV_FREE);
+}
+
+// 크기 -> (fl, sl) 클래스
+static void mapping_insert(size_t size, int* fli, int* sli) {
+    int fl, sl;
+    if (size < SMALL_BLOCK_SIZE) {
+        fl = 0;
+        sl = (int)(size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT));
+    } else {
+        fl = tlsf_fls((uint32_t)size);
+        sl = (int)((size >> (fl - SL_INDEX_COUNT_LOG2)) ^ (1u << SL_INDEX_COUNT_LOG2));
+        fl -= FL_INDEX_SHIFT - 1;
+    }
+    *fli = fl;
+    *sli = sl;
+}
+
+// 할당용: 클래스 안의 어떤 블록이든 size 이상이 되도록 다음 클래스 경계로 올림
+static void mapping_search(size_t size, int* fli, int* sli) {
+    if (size >= SMALL_BLOCK_SIZE) {
+        size_t round = ((size_t)1 << (tlsf_fls((uint32_t)size) - SL_INDEX_COUNT_LOG2)) - 1;
+        size += round;
+    }
+    mapping_insert(size, fli, sli);
+}
+
+static block_header_t* search_suitable_block(int* fli, int* sli) {
+    int fl = *fli;
+    int sl = *sli;
+
+    // 같은 1단계 안에서 sl 이상인 클래스
+    uint32_t sl_map = sl_bitmap[fl] & (~0u << sl);
+    if (!sl_map) {
+        // 더 큰 1단계 클래스
+        uint32_t fl_map = fl_bitmap & (~0u << (fl + 1));
+        if (!fl_map) {
+            return NULL;
+        }
+        fl = tlsf_ffs(fl_map);
+        sl_map = sl_bitmap[fl];
+    }
+    sl = tlsf_ffs(sl_map);
+
+    *fli = fl;
+    *sli = sl;
+    return free_lists[fl][sl];
+}
+
+static void remove_free_block(block_header_t* block, int fl, int sl) {
+    block_header_t* prev = block->prev_free;
+    block_header_t* next = block->next_free;
+    if (next) {
+        next->prev_free = prev;
+    }
+    if (prev) {
+        prev->next_free = next;
+    } else {
+        free_lists[fl][sl] = next;
+        if (!next) {
+            sl_bitmap[fl] &= ~(1u << sl);
+            if (!sl_bitmap[fl]) {
+                fl_bitmap &= ~(1u << fl);
+            }
+        }
+    }
+    block->next_free = NULL;
+    block->prev_free = NULL;
+}
+
+static void insert_free_block(block_header_t* block, int fl, int sl) {
+    block_header_t* head = free_lists[fl][sl];
+    block->next_free = head;
+    block->prev_free = NULL;
+    if (head) {
+        head->prev_free = block;
+    }
+    free_lists[fl][sl] = block;
+    fl_bitmap |= 1u << fl;
+    sl_bitmap[fl] |= 1u << sl;
+}
+
+static void block_remove(block_header_t* block) {
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    remove_free_block(block, fl, sl);
+}
+
+static void block_insert(block_header_t* block) {
+    int fl, sl;
+    mapping_insert(block_size(block), &fl, &sl);
+    insert_free_block(block, fl, sl);
+}
+
+static block_header_t* merge_free_blocks(block_header_t* block);
+
+static inline uintptr_t page_round_up(uintptr_t addr) {
+    return (addr + PAGE_SIZE - 1) & ~(uintptr_t)(PAGE_SIZE - 1);
+}
+
+static inline uintptr_t page_round_down(uintptr_t addr) {
+    return addr & ~(uintptr_t)(PAGE_SIZE - 1);
 }
 
-// 새로운 페이지를 힙에 추가
-// pmm_alloc_pages는 원자적으로 동작하므로 부분 할당 없음
+// arena [start, end) 중 매핑 안 된 페이지를 프레임 하나씩 매핑
+// 힙은 가상 주소로만 연속이면 되므로 물리 프레임은 흩어져 있어도 됨 (HIGH zone 우선)
+static bool heap_populate(uintptr_t start, uintptr_t end) {
+    void* page_dir = vmm_get_kernel_page_dir();
+    for (uintptr_t virt = start; virt < end; virt += PAGE_SIZE) {
+        if (vmm_lookup_phys(page_dir, (void*)virt)) {
+            continue;
+        }
+        phys_addr_t frame = pmm_alloc_frame();
+        if (!frame || !vmm_map_phys(page_dir, (void*)virt, frame, VMM_WRITABLE)) {
+            if (frame) {
+                pmm_free_frame(frame);
+            }
+            return false;
+        }
+        total_heap_size += PAGE_SIZE;
+    }
+    return true;
+}
+
+// arena [start, end)의 매핑된 페이지를 언매핑하고 프레임을 PMM에 반환, 반환한 페이지 수
+static uint32_t heap_depopulate(uintptr_t start, uintptr_t end) {
+    void* page_dir = vmm_get_kernel_page_dir();
+    uint32_t released = 0;
+    for (uintptr_t virt = start; virt < end; virt += PAGE_SIZE) {
+        phys_addr_t frame = vmm_lookup_phys(page_dir, (void*)virt);
+        if (frame && vmm_unmap_page(page_dir, (void*)virt)) {
+            pmm_free_frame(frame);
+            total_heap_size -= PAGE_SIZE;
+            released++;
+        }
+    }
+    return released;
+}
+
+// arena 끝 sentinel: 크기 0의 사용 중 블록이라 병합이 매핑된 영역 밖으로 나가지 않음
+static void heap_write_sentinel(uintptr_t brk, bool prev_free) {
+    block_header_t* sentinel = (block_header_t*)(brk - HEADER_SIZE);
+    sentinel->size = prev_free ? BLOCK_FLAG_PREV_FREE : 0;
+}
+
+// 힙 arena 끝(heap_brk)에 페이지를 매핑해 힙을 늘림 (min_size는 헤더 포함 블록 크기)
+// 기존 끝 sentinel 자리가 새 free 블록의 헤더가 되고 새 끝에 sentinel을 다시 둠
+// 주소가 연속이므로 마지막 free 블록과 그대로 병합됨
 static bool expand_heap(size_t min_size) {
-    // 필요한 페이지 수 계산
-    size_t needed = min_size + HEADER_SIZE;
+    bool first = heap_brk == VMM_KHEAP_START;
+
+    // 필요한 페이지 수 계산 (첫 확장은 앞쪽 정렬 여백 + 끝 sentinel 포함, 이후는 sentinel 자리를 재사용)
+    size_t needed = min_size;
+    if (first) {
+        needed += (HEAP_FIRST_BLOCK - VMM_KHEAP_START) + HEADER_SIZE;
+    }
     uint32_t pages_needed = (needed + PAGE_SIZE - 1) / PAGE_SIZE;
-    
-    // 연속된 페이지 할당 (원자적: 모두 성공 or 모두 실패)
-    // 부분 할당으로 인한 메모리 누수 없음
-    void* new_pages = pmm_alloc_pages(pages_needed);
-    if (!new_pages) {
-        console_puts("[KMALLOC] Failed to allocate ");
-        // 간단한 숫자 출력
-        uint32_t pn = pages_needed;
-        char buf[12];
-        int idx = 0;
-        while (pn > 0 && idx < 11) {
-            buf[idx++] = (char)('0' + (pn % 10));
-            pn /= 10;
-        }
-        while (idx--) console_putc(buf[idx]);
-        console_puts(" contiguous pages\n");
+
+    if (pages_needed > (VMM_KHEAP_END - heap_brk) / PAGE_SIZE) {
+        console_puts("[KMALLOC] Heap arena exhausted\n");
+        return false;
+    }
+
+    uintptr_t new_brk = heap_brk + pages_needed * PAGE_SIZE;
+    if (!heap_populate(heap_brk, new_brk)) {
+        heap_depopulate(heap_brk, new_brk);
+        console_puts("[KMALLOC] Failed to map ");
+        console_putu32(pages_needed);
+        console_puts(" heap pages\n");
         return false;
     }
-    
-    block_header_t* new_block = (block_header_t*)new_pages;
-    size_t block_size = pages_needed * PAGE_SIZE - HEADER_SIZE;
-    
-    new_block->size = block_size;
-    new_block->is_free = true;
-    new_block->next = NULL;
-    new_block->prev = heap_end;
-    new_block->magic = BLOCK_MAGIC;
-    
-    if (heap_end) {
-        heap_end->next = new_block;
-    }
-    
-    heap_end = new_block;
-    
-    if (!heap_start) {
-        heap_start = new_block;
-    }
-    
-    total_heap_size += pages_needed * PAGE_SIZE;
-    free_bytes += block_size;
-    
+
+    block_header_t* new_block;
+    if (first) {
+        new_block = (block_header_t*)HEAP_FIRST_BLOCK;
+        new_block->size = 0;
+    } else {
+        // 이전 sentinel (PREV_FREE 비트는 그대로 유지)
+        new_block = (block_header_t*)(heap_brk - HEADER_SIZE);
+    }
+    block_set_size(new_block, new_brk - HEADER_SIZE - (uintptr_t)new_block);
+
+    heap_write_sentinel(new_brk, false);
+    block_mark_free(new_block);
+
+    heap_brk = new_brk;
+    free_bytes += block_size(new_block) - HEADER_SIZE;
+
+    block_insert(merge_free_blocks(new_block));
+
     return true;
 }
 
-// 블록 분할
-// 주의: free_bytes는 호출자가 관리해야 함 (이 함수는 블록 구조만 변경)
+// 블록 분할: 앞쪽 size 바이트(헤더 포함)만 남기고 뒤쪽을 free 블록으로 만들어 리스트에 넣음
+// 앞쪽은 호출자가 곧 사용 중으로 만드므로 뒤쪽 블록의 PREV_FREE는 켜지 않음
 static void split_block(block_header_t* block, size_t size) {
-    if (block->size < size + HEADER_SIZE + MIN_BLOCK_SIZE) {
+    size_t total = block_size(block);
+    if (total < size + MIN_BLOCK_SIZE) {
         // 분할할 만큼 크지 않음
         return;
     }
-    
-    size_t old_size = block->size;
-    
-    // 새 블록 생성 (남는 부분)
-    block_header_t* new_block = (block_header_t*)((uint8_t*)block + HEADER_SIZE + size);
-    new_block->size = old_size - size - HEADER_SIZE;
-    new_block->is_free = true;
-    new_block->next = block->next;
-    new_block->prev = block;
-    new_block->magic = BLOCK_MAGIC;
-    
-    if (block->next) {
-        block->next->prev = new_block;
-    } else {
-        heap_end = new_block;
-    }
-    
-    block->next = new_block;
-    block->size = size;
-    
-    // 분할 후 free_bytes 조정 필요 없음:
-    // - 원래 블록 전체가 free였고
-    // - 분할 후에도 (사용 부분 + 헤더 + 남는 free 부분) = 원래 크기
-    // - 호출자(kmalloc)가 사용 부분을 free_bytes에서 뺄 것임
-}
-
-// 인접한 free 블록 병합
-// 앞뒤로 연속된 모든 free 블록을 병합
-static void merge_free_blocks(block_header_t* block) {
-    if (!block || !block->is_free) {
+
+    block_header_t* rest = (block_header_t*)((uint8_t*)block + size);
+    rest->size = (total - size) | (block->size & BLOCK_FLAG_HOLES);
+    block_mark_free(rest);
+
+    block_set_size(block, size);
+    free_bytes += block_size(rest) - HEADER_SIZE;
+    block_insert(rest);
+}
+
+// 물리적으로 인접한 free 블록 병합, 병합된 블록 반환 (block은 FREE로 표시된 상태)
+// 해제 때마다 병합하므로 앞뒤로 한 블록씩만 보면 됨
+// 사이에 있던 헤더가 데이터 영역이 되므로 free_bytes도 그만큼 늘어남
+static block_header_t* merge_free_blocks(block_header_t* block) {
+    if (block_test(block, BLOCK_FLAG_PREV_FREE)) {
+        block_header_t* prev = block_prev_phys(block);
+        block_remove(prev);
+        block_set_size(prev, block_size(prev) + block_size(block));
+        prev->size |= block->size & BLOCK_FLAG_HOLES;
+        free_bytes += HEADER_SIZE;
+        block = prev;
+    }
+
+    block_header_t* next = block_next_phys(block);
+    if (block_test(next, BLOCK_FLAG_FREE)) {
+        block_remove(next);
+        block_set_size(block, block_size(block) + block_size(next));
+        block->size |= next->size & BLOCK_FLAG_HOLES;
+        free_bytes += HEADER_SIZE;
+    }
+
+    block_mark_free(block);
+    return block;
+}
+
+// 큰 free 블록의 페이지를 PMM에 반환 (블록은 free 리스트에 들어가기 전 상태)
+// - arena 끝 블록이면 sentinel을 앞으로 당겨 heap_brk 자체를 줄임
+// - 중간 블록이면 헤더(+ 리스트 포인터)가 있는 첫 페이지와 footer가 있는 마지막 페이지만 남기고
+//   온전히 덮는 페이지를 언매핑 (구멍), 구멍은 그 블록에서 다시 할당할 때 heap_populate로 채움
+static void heap_trim_block(block_header_t* block) {
+    size_t size = block_size(block);
+    if (shrink_threshold == 0 || size < shrink_threshold) {
         return;
     }
-    
-    // 1단계: 이전 블록들과 병합 (뒤로 이동하면서)
-    // block->prev가 free면 block을 prev로 이동
-    while (block->prev && block->prev->is_free) {
-        block = block->prev;
-    }
-    
-    // 2단계: 현재 위치(가장 앞)에서 다음 블록들과 병합
-    while (block->next && block->next->is_free) {
-        block_header_t* next_block = block->next;
-        
-        // 다음 블록을 현재 블록에 병합
-        block->size += HEADER_SIZE + next_block->size;
-        block->next = next_block->next;
-        
-        if (block->next) {
-            block->next->prev = block;
-        } else {
-            heap_end = block;
+
+    uintptr_t start = (uintptr_t)block;
+    block_header_t* next = block_next_phys(block);
+    uint32_t released;
+
+    if ((uintptr_t)next + HEADER_SIZE == heap_brk) {
+        uintptr_t new_brk = page_round_up(start + MIN_BLOCK_SIZE + HEADER_SIZE);
+        if (new_brk < VMM_KHEAP_START + KMALLOC_MIN_HEAP_SIZE) {
+            new_brk = VMM_KHEAP_START + KMALLOC_MIN_HEAP_SIZE;
+        }
+        // 새 footer와 sentinel이 놓일 페이지는 매핑되어 있어야 함
+        if (new_brk >= heap_brk || !heap_populate(new_brk - PAGE_SIZE, new_brk)) {
+            return;
+        }
+
+        size_t new_size = new_brk - HEADER_SIZE - start;
+        free_bytes -= size - new_size;
+        block_set_size(block, new_size);
+        heap_write_sentinel(new_brk, true);
+        block_mark_free(block);
+
+        released = heap_depopulate(new_brk, heap_brk);
+        heap_brk = new_brk;
+    } else {
+        released = heap_depopulate(page_round_up(start + sizeof(block_header_t)),
+                                   page_round_down((uintptr_t)next - FOOTER_SIZE));
+        if (released) {
+            block_set(block, BLOCK_FLAG_HOLES);
         }
     }
+
+    pages_released += released;
 }
 
 void kmalloc_init(void) {
     console_puts("[KMALLOC] Initializing kernel heap allocator...\n");
-    
-    heap_start = NULL;
-    heap_end = NULL;
+
+    fl_bitmap = 0;
+    for (int fl = 0; fl < FL_INDEX_COUNT; fl++) {
+        sl_bitmap[fl] = 0;
+        for (uint32_t sl = 0; sl < SL_INDEX_COUNT; sl++) {
+            free_lists[fl][sl] = NULL;
+        }
+    }
+    heap_brk = VMM_KHEAP_START;
     total_heap_size = 0;
     used_bytes = 0;
     free_bytes = 0;
-    
-    // 초기 힙 크기: 4 페이지 (16KB)
-    if (!expand_heap(4 * PAGE_SIZE)) {
+    pages_released = 0;
+
+    // 초기 힙 크기: 4 페이지 (16KB), 축소해도 이 아래로는 줄이지 않음
+    if (!expand_heap(KMALLOC_MIN_HEAP_SIZE - (HEAP_FIRST_BLOCK - VMM_KHEAP_START) - HEADER_SIZE)) {
         console_puts("[KMALLOC] Failed to initialize heap\n");
         return;
     }
-    
+
     console_puts("[KMALLOC] Heap initialized\n");
 }
 
-void* kmalloc(size_t size) {
-    if (size == 0) {
-        return NULL;
+// size(헤더 포함) 이상인 free 블록을 찾아 free 리스트에서 꺼냄 (없으면 힙 확장)
+// 호출자가 irq_save 상태여야 함
+static block_header_t* heap_take_free_block(size_t size) {
+    int fl, sl;
+    mapping_search(size, &fl, &sl);
+
+    block_header_t* block = search_suitable_block(&fl, &sl);
+    if (!block) {
+        // 적합한 블록이 없으면 힙 확장 후 한 번 더 찾음
+        // 검색 클래스로 올림한 크기까지 담을 수 있어야 새 청크가 반드시 검색됨
+        size_t want = size;
+        if (want >= SMALL_BLOCK_SIZE) {
+            want += ((size_t)1 << (tlsf_fls((uint32_t)want) - SL_INDEX_COUNT_LOG2)) - 1;
+        }
+        if (!expand_heap(want)) {
+            return NULL;
+        }
+        mapping_search(size, &fl, &sl);
+        block = search_suitable_block(&fl, &sl);
+        if (!block) {
+            return NULL;
+        }
     }
-    
-    // 크기 정렬
-    size = align_size(size);
-    
-    // 재귀 대신 루프 사용 (커널에서 재귀는 스택 오버플로우 위험)
-    while (1) {
-        // First-fit 알고리즘으로 적합한 블록 찾기
-        block_header_t* current = heap_start;
-        while (current) {
-            if (current->is_free && current->size >= size) {
-                // 블록 분할 (가능하면)
-                split_block(current, size);
-                // 분할 후 current->size는 size로 변경됨
-                // 남는 부분은 새로운 free 블록으로 생성됨
-                
-                current->is_free = false;
-                
-                // free_bytes 업데이트:
-                // - 실제 사용하는 current->size를 뺌
-                // - 분할로 생긴 남는 블록은 여전히 free이므로 자동으로 반영됨
-                used_bytes += current->size;
-                free_bytes -= current->size;
-                
-                // 데이터 영역 반환 (헤더 다음)
-                return (void*)((uint8_t*)current + HEADER_SIZE);
-            }
-            current = current->next;
+
+    remove_free_block(block, fl, sl);
+    return block;
+}
+
+// 꺼낸 free 블록 앞쪽 size 바이트(헤더 포함)를 사용 중으로 만들고 데이터 주소 반환
+// 실패하면 (구멍을 채울 프레임 부족) 블록을 free 리스트로 되돌리고 NULL
+static void* heap_use_block(block_header_t* block, size_t size) {
+    // 구멍이 있는 블록이면 할당할 부분(+ 분할로 생길 헤더와 리스트 포인터)의 페이지를 다시 매핑
+    if (block_test(block, BLOCK_FLAG_HOLES)) {
+        uintptr_t start = (uintptr_t)block;
+        uintptr_t end = (uintptr_t)block_next_phys(block);
+        if (block_size(block) >= size + MIN_BLOCK_SIZE) {
+            end = start + size + sizeof(block_header_t);
+        }
+        if (!heap_populate(page_round_down(start), page_round_up(end))) {
+            block_insert(merge_free_blocks(block));
+            return NULL;
+        }
+    }
+
+    free_bytes -= block_size(block) - HEADER_SIZE;
+    split_block(block, size);
+    block_mark_used(block);
+    used_bytes += block_size(block) - HEADER_SIZE;
+
+    // 데이터 영역 반환 (헤더 다음)
+    return block_to_ptr(block);
+}
+
+// 크기 -> 히스토그램 칸 ([2^i, 2^(i+1)))
+static inline uint32_t profile_bin(uint32_t size) {
+    int bin = tlsf_fls(size);
+    return bin < 0 ? 0 : ((uint32_t)bin < PROFILE_HIST_BINS ? (uint32_t)bin : PROFILE_HIST_BINS - 1);
+}
+
+static inline uint32_t profile_hash(uintptr_t value, uint32_t bits) {
+    return ((uint32_t)(value >> 3) * 2654435761u) >> (32 - bits);
+}
+
+// 호출 위치 칸 찾기 (처음 보는 위치면 새로 등록, 표가 가득 차면 0번 "기타")
+static uint32_t profile_site_index(uintptr_t addr) {
+    uint32_t slots = PROFILE_SITE_COUNT - 1;
+    uint32_t idx = profile_hash(addr, 6) % slots;
+    for (uint32_t probe = 0; probe < slots; probe++) {
+        profile_site_t* site = &profile_sites[1 + idx];
+        if (site->addr == addr) {
+            return 1 + idx;
+        }
+        if (site->addr == 0) {
+            site->addr = addr;
+            return 1 + idx;
+        }
+        idx = (idx + 1) % slots;
+    }
+    return 0;
+}
+
+// 할당 기록 (호출자가 irq_save 상태)
+static void profile_track(void* ptr, uint32_t size, uintptr_t caller) {
+    if (profile_tracked >= PROFILE_TRACK_COUNT - 1) {
+        profile_dropped++;
+        return;
+    }
+
+    uint32_t site_idx = profile_site_index(caller);
+    profile_site_t* site = &profile_sites[site_idx];
+    site->live_bytes += size;
+    site->live_count++;
+    site->total_count++;
+    if (site->live_bytes > site->peak_bytes) {
+        site->peak_bytes = site->live_bytes;
+    }
+    profile_hist_total[profile_bin(size)]++;
+    profile_hist_live[profile_bin(size)]++;
+
+    uint32_t idx = profile_hash((uintptr_t)ptr, PROFILE_TRACK_BITS);
+    while (profile_table[idx].ptr) {
+        idx = (idx + 1) & (PROFILE_TRACK_COUNT - 1);
+    }
+    profile_table[idx].ptr = (uintptr_t)ptr;
+    profile_table[idx].size = size;
+    profile_table[idx].site = site_idx;
+    profile_tracked++;
+}
+
+// 해제 기록 (기록된 적 없는 블록이면 무시), 선형 탐사 표라 뒤쪽 항목을 당겨 빈 칸을 메움
+static void profile_untrack(void* ptr) {
+    uint32_t idx = profile_hash((uintptr_t)ptr, PROFILE_TRACK_BITS);
+    while (profile_table[idx].ptr != (uintptr_t)ptr) {
+        if (!profile_table[idx].ptr) {
+            return;
+        }
+        idx = (idx + 1) & (PROFILE_TRACK_COUNT - 1);
+    }
+
+    profile_entry_t* entry = &profile_table[idx];
+    profile_site_t* site = &profile_sites[entry->site];
+    site->live_bytes -= entry->size;
+    site->live_count--;
+    profile_hist_live[profile_bin(entry->size)]--;
+    profile_tracked--;
+
+    uint32_t hole = idx;
+    for (;;) {
+        idx = (idx + 1) & (PROFILE_TRACK_COUNT - 1);
+        if (!profile_table[idx].ptr) {
+            break;
+        }
+        // 원래 칸이 (hole, idx] 밖이면 hole로 옮겨도 탐사 경로가 유지됨
+        uint32_t home = profile_hash(profile_table[idx].ptr, PROFILE_TRACK_BITS);
+        if (((idx - home) & (PROFILE_TRACK_COUNT - 1)) >= ((idx - hole) & (PROFILE_TRACK_COUNT - 1))) {
+            profile_table[hole] = profile_table[idx];
+            hole = idx;
         }
-        
-        // 적합한 블록이 없으면 힙 확장
-        if (!expand_heap(size)) {
+    }
+    profile_table[hole].ptr = 0;
+}
+
+// 제자리 krealloc: 기존 기록을 지우고 새 크기/호출 위치로 다시 기록
+static void profile_retrack(void* ptr, uint32_t size, uintptr_t caller) {
+    if (profile_tracked) {
+        profile_untrack(ptr);
+    }
+    if (profile_enabled) {
+        profile_track(ptr, size, caller);
+    }
+}
+
+static void* kmalloc_at(size_t size, uintptr_t caller) {
+    if (size == 0 || size > BLOCK_SIZE_MAX / 2) {
+        return NULL;
+    }
+
+    // 헤더 포함 블록 크기
+    size_t block_bytes = adjust_request(size);
+
+    uint32_t irq = irq_save();
+    block_header_t* block = heap_take_free_block(block_bytes);
+    void* ptr = block ? heap_use_block(block, block_bytes) : NULL;
+    if (ptr && profile_enabled) {
+        profile_track(ptr, (uint32_t)size, caller);
+    }
+    irq_restore(irq);
+
+    if (!ptr) {
+        console_puts("[KMALLOC] Out of memory\n");
+    }
+    return ptr;
+}
+
+// 공개 진입점은 인라인되지 않아야 __builtin_return_address(0)가 실제 호출 위치를 가리킴
+__attribute__((noinline)) void* kmalloc(size_t size) {
+    return kmalloc_at(size, (uintptr_t)__builtin_return_address(0));
+}
+
+// align 경계에 맞춘 할당 (align은 2의 거듭제곱)
+// size + align + 최소 블록만큼의 free 블록을 잡은 뒤,
+// 정렬된 주소 앞쪽 남는 부분을 별도 free 블록으로 떼어 냄
+static void* kmalloc_aligned_at(size_t size, size_t align, uintptr_t caller) {
+    if (align <= ALIGN_SIZE) {
+        return kmalloc_at(size, caller);
+    }
+    if ((align & (align - 1)) != 0 || align > BLOCK_SIZE_MAX / 4 ||
+        size == 0 || size > BLOCK_SIZE_MAX / 4) {
+        return NULL;
+    }
+
+    size_t request = size;
+    size = adjust_request(size);
+
+    uint32_t irq = irq_save();
+    block_header_t* block = heap_take_free_block(size + align + MIN_BLOCK_SIZE);
+    if (!block) {
+        irq_restore(irq);
+        console_puts("[KMALLOC] Out of memory\n");
+        return NULL;
+    }
+
+    // 앞쪽 gap은 그 자체로 free 블록(최소 크기)이 될 수 있어야 함
+    uintptr_t data = (uintptr_t)block_to_ptr(block);
+    uintptr_t aligned = (data + align - 1) & ~(uintptr_t)(align - 1);
+    if (aligned != data && aligned - data < MIN_BLOCK_SIZE) {
+        aligned = (data + MIN_BLOCK_SIZE + align - 1) & ~(uintptr_t)(align - 1);
+    }
+
+    if (aligned != data) {
+        block_header_t* lead = block;
+        block = ptr_to_block((void*)aligned);
+
+        // 앞 gap의 footer와 새 헤더가 놓일 페이지가 반환된 구멍일 수 있음
+        if (block_test(lead, BLOCK_FLAG_HOLES) &&
+            !heap_populate(page_round_down((uintptr_t)block - FOOTER_SIZE),
+                           page_round_up((uintptr_t)block + sizeof(block_header_t)))) {
+            block_insert(lead);
+            irq_restore(irq);
             console_puts("[KMALLOC] Out of memory\n");
             return NULL;
         }
-        
-        // 힙 확장 성공, 다시 루프 시작하여 블록 찾기
+
+        block->size = (block_size(lead) - (aligned - data)) | (lead->size & BLOCK_FLAG_HOLES);
+        block_set_size(lead, aligned - data);
+        block_mark_free(lead);
+        block_mark_free(block);
+
+        // 앞쪽 gap은 free로 남김 (앞 블록은 free일 수 없으므로 병합 불필요)
+        free_bytes -= HEADER_SIZE;
+        block_insert(lead);
+    }
+
+    void* ptr = heap_use_block(block, size);
+    if (ptr && profile_enabled) {
+        profile_track(ptr, (uint32_t)request, caller);
+    }
+    irq_restore(irq);
+
+    if (!ptr) {
+        console_puts("[KMALLOC] Out of memory\n");
+    }
+    return ptr;
+}
+
+__attribute__((noinline)) void* kmalloc_aligned(size_t size, size_t align) {
+    return kmalloc_aligned_at(size, align, (uintptr_t)__builtin_return_address(0));
+}
+
+// 페이지 단위 할당 (페이지 경계에 정렬)
+__attribute__((noinline)) void* kmalloc_pages(uint32_t count) {
+    if (count == 0) {
+        return NULL;
+    }
+    return kmalloc_aligned_at((size_t)count * PAGE_SIZE, PAGE_SIZE, (uintptr_t)__builtin_return_address(0));
+}
+
+// kfree/krealloc에 넘어온 포인터 검증, 사용 중 블록의 헤더 (잘못된 포인터면 NULL)
+// 호출자가 irq_save 상태여야 함
+// 매직 넘버 대신 헤더 크기와 다음 블록의 PREV_FREE 비트가 서로 맞는지로 손상을 감지
+static block_header_t* heap_check_ptr(void* ptr, const char* who) {
+    // 힙 arena 밖이거나 반환된 페이지를 가리키면 헤더를 읽지 않고 거부
+    uintptr_t addr = (uintptr_t)ptr;
+    void* page_dir = vmm_get_kernel_page_dir();
+    if (addr < HEAP_FIRST_BLOCK + HEADER_SIZE || addr >= heap_brk || (addr & (ALIGN_SIZE - 1)) ||
+        (total_heap_size != heap_brk - VMM_KHEAP_START &&
+         (!vmm_lookup_phys(page_dir, (void*)(addr - HEADER_SIZE)) ||
+          !vmm_lookup_phys(page_dir, (void*)(addr - 1))))) {
+        console_puts(who);
+        console_puts(" Pointer outside kernel heap\n");
+        return NULL;
+    }
+
+    // 헤더 위치 계산
+    block_header_t* block = ptr_to_block(ptr);
+
+    // 이미 free된 블록인지 확인 (double free 방지)
+    if (block_test(block, BLOCK_FLAG_FREE)) {
+        console_puts(who);
+        console_puts(" Double free detected\n");
+        return NULL;
     }
+
+    // 크기가 sentinel을 넘거나 다음 블록이 이 블록을 free로 알고 있으면 손상
+    size_t size = block_size(block);
+    if (size < MIN_BLOCK_SIZE || size > heap_brk - HEADER_SIZE - (uintptr_t)block ||
+        block_test(block_next_phys(block), BLOCK_FLAG_PREV_FREE)) {
+        console_puts(who);
+        console_puts(" Invalid block header - corrupted block\n");
+        return NULL;
+    }
+
+    return block;
 }
 
 bool kfree(void* ptr) {
     if (!ptr) {
         return false;
     }
-    
-    // 헤더 위치 계산
-    block_header_t* block = (block_header_t*)((uint8_t*)ptr - HEADER_SIZE);
-    
-    // 매직 넘버 검증
-    if (block->magic != BLOCK_MAGIC) {
-        console_puts("[KFREE] Invalid magic number - corrupted block\n");
+
+    // 검증도 irq_save 안에서 (검사 후 다른 쪽이 블록/힙 끝을 바꾸지 못하게)
+    uint32_t irq = irq_save();
+
+    block_header_t* block = heap_check_ptr(ptr, "[KFREE]");
+    if (!block) {
+        irq_restore(irq);
         return false;
     }
-    
-    // 이미 free된 블록인지 확인 (double free 방지)
-    if (block->is_free) {
-        console_puts("[KFREE] Double free detected\n");
-        return false;
+
+    if (profile_tracked) {
+        profile_untrack(ptr);
     }
-    
-    // 블록 해제
-    block->is_free = true;
-    used_bytes -= block->size;
-    free_bytes += block->size;
-    
-    // 인접 블록 병합
-    merge_free_blocks(block);
-    
+
+    // 블록 해제 (앞 블록에 병합되어도 이 헤더에 FREE가 남아 double free를 잡음)
+    block_set(block, BLOCK_FLAG_FREE);
+    used_bytes -= block_size(block) - HEADER_SIZE;
+    free_bytes += block_size(block) - HEADER_SIZE;
+
+    // 인접 블록 병합, 충분히 크면 페이지 반환 후 크기 클래스 리스트에 넣음
+    block = merge_free_blocks(block);
+    heap_trim_block(block);
+    block_insert(block);
+
+    irq_restore(irq);
     return true;
 }
 
+// 워드 단위 복사 (데이터 크기 = 블록 크기 - 헤더이므로 n은 4의 배수)
+// 컴파일러가 바이트 루프를 memcpy 호출로 바꾸지 않도록 rep movsl 사용
+static void heap_copy_words(void* dst, const void* src, size_t n) {
+    size_t words = n / 4;
+    __asm__ __volatile__("rep movsl"
+                         : "+D"(dst), "+S"(src), "+c"(words)
+                         :
+                         : "memory");
+}
+
+// 사용 중 블록 뒤에 남는 부분을 free로 떼어 내고 뒤쪽 free 블록과 병합
+static void heap_shrink_block(block_header_t* block, size_t size) {
+    size_t old_size = block_size(block);
+    split_block(block, size);
+    if (block_size(block) == old_size) {
+        return;
+    }
+
+    used_bytes -= old_size - block_size(block);
+
+    block_header_t* rest = block_next_phys(block);
+    block_remove(rest);
+    rest = merge_free_blocks(rest);
+    heap_trim_block(rest);
+    block_insert(rest);
+}
+
+__attribute__((noinline)) void* krealloc(void* ptr, size_t size) {
+    uintptr_t caller = (uintptr_t)__builtin_return_address(0);
+    if (!ptr) {
+        return kmalloc_at(size, caller);
+    }
+    if (size == 0) {
+        kfree(ptr);
+        return NULL;
+    }
+    if (size > BLOCK_SIZE_MAX / 2) {
+        return NULL;
+    }
+
+    size_t request = size;
+    size = adjust_request(size);
+
+    uint32_t irq = irq_save();
+
+    block_header_t* block = heap_check_ptr(ptr, "[KREALLOC]");
+    if (!block) {
+        irq_restore(irq);
+        return NULL;
+    }
+
+    // 줄이기: 제자리에서 분할
+    if (size <= block_size(block)) {
+        heap_shrink_block(block, size);
+        profile_retrack(ptr, (uint32_t)request, caller);
+        irq_restore(irq);
+        return ptr;
+    }
+
+    // 늘리기: 바로 뒤 블록이 free이고 합쳐서 충분하면 제자리에서 흡수
+    block_header_t* next = block_next_phys(block);
+    size_t combined = block_size(block) + block_size(next);
+    if (block_test(next, BLOCK_FLAG_FREE) && combined >= size) {
+        uintptr_t end = (uintptr_t)block_next_phys(next);
+        if (combined >= size + MIN_BLOCK_SIZE) {
+            end = (uintptr_t)block + size + sizeof(block_header_t);
+        }
+
+        // next 안의 반환된 페이지 중 새로 쓰게 될 부분을 다시 매핑
+        if (!block_test(next, BLOCK_FLAG_HOLES) ||
+            heap_populate(page_round_down((uintptr_t)next), page_round_up(end))) {
+            size_t old_size = block_size(block);
+            size_t next_holes = next->size & BLOCK_FLAG_HOLES;
+
+            block_remove(next);
+            free_bytes -= block_size(next) - HEADER_SIZE;
+            block_set_size(block, combined);
+            block_clear(block_next_phys(block), BLOCK_FLAG_PREV_FREE);
+            used_bytes += combined - old_size;
+
+            // 남는 뒤쪽은 다시 free로 (next의 구멍 표시는 그쪽으로 넘어감)
+            block_set(block, next_holes);
+            heap_shrink_block(block, size);
+            block_clear(block, BLOCK_FLAG_HOLES);
+            profile_retrack(ptr, (uint32_t)request, caller);
+
+            irq_restore(irq);
+            return ptr;
+        }
+    }
+
+    size_t old_data = block_size(block) - HEADER_SIZE;
+    irq_restore(irq);
+
+    // 제자리에서 안 되면 새로 할당해서 복사
+    void* new_ptr = kmalloc_at(request, caller);
+    if (!new_ptr) {
+        return NULL;
+    }
+    heap_copy_words(new_ptr, ptr, old_data);
+    kfree(ptr);
+    return new_ptr;
+}
+
+size_t kmalloc_block_bytes(const void* ptr) {
+    if (!ptr) {
+        return 0;
+    }
+    return block_size((const block_header_t*)((const uint8_t*)ptr - HEADER_SIZE));
+}
+
 uint32_t kmalloc_used_bytes(void) {
     return used_bytes;
 }
 
+// heap_brk 아래에서 매핑이 빠진 바이트 = free 블록 안의 구멍 (PMM에 반환된 페이지)
+// 구멍은 heap_trim_block이 free 블록 데이터 안에서만 만들므로 항상 free_bytes에 포함됨
+static inline uint32_t heap_hole_bytes(void) {
+    return (uint32_t)(heap_brk - VMM_KHEAP_START) - total_heap_size;
+}
+
+// 실제로 매핑된 free 데이터 크기 (구멍 제외 -> used + free가 total을 넘지 않음)
 uint32_t kmalloc_free_bytes(void) {
-    return free_bytes;
+    uint32_t irq = irq_save();
+    uint32_t holes = heap_hole_bytes();
+    uint32_t free = free_bytes > holes ? free_bytes - holes : 0;
+    irq_restore(irq);
+    return free;
+}
+
+uint32_t kmalloc_hole_bytes(void) {
+    uint32_t irq = irq_save();
+    uint32_t holes = heap_hole_bytes();
+    irq_restore(irq);
+    return holes;
 }
 
 uint32_t kmalloc_total_bytes(void) {
     return total_heap_size;
 }
+
+// 가장 큰 free 블록의 데이터 크기 (free_bytes와 비교해 외부 단편화 측정)
+// 가장 높은 비어 있지 않은 클래스 리스트만 훑으면 됨
+uint32_t kmalloc_largest_free_block(void) {
+    uint32_t irq = irq_save();
+    size_t largest = 0;
+    int fl = tlsf_fls(fl_bitmap);
+    if (fl >= 0) {
+        int sl = tlsf_fls(sl_bitmap[fl]);
+        for (block_header_t* block = free_lists[fl][sl]; block; block = block->next_free) {
+            if (block_size(block) > largest) {
+                largest = block_size(block);
+            }
+        }
+    }
+    irq_restore(irq);
+    return largest ? (uint32_t)(largest - HEADER_SIZE) : 0;
+}
+
+uint32_t kmalloc_pages_released(void) {
+    return pages_released;
+}
+
+void kmalloc_set_shrink_threshold(uint32_t bytes) {
+    shrink_threshold = bytes;
+}
+
+void kmalloc_profile_enable(bool enable) {
+    uint32_t irq = irq_save();
+    profile_enabled = enable;
+    irq_restore(irq);
+}
+
+bool kmalloc_profile_enabled(void) {
+    return profile_enabled;
+}
+
+void kmalloc_profile_dump(void) {
+    uint32_t irq = irq_save();
+
+    // free 블록 수와 가장 큰 블록 (모든 클래스 리스트를 훑음)
+    uint32_t free_blocks = 0;
+    size_t largest = 0;
+    for (int fl = 0; fl < FL_INDEX_COUNT; fl++) {
+        for (uint32_t sl = 0; sl < SL_INDEX_COUNT; sl++) {
+            for (block_header_t* block = free_lists[fl][sl]; block; block = block->next_free) {
+                free_blocks++;
+                if (block_size(block) > largest) {
+                    largest = block_size(block);
+                }
+            }
+        }
+    }
+    uint32_t largest_data = largest ? (uint32_t)(largest - HEADER_SIZE) : 0;
+
+    // 외부 단편화 = 1 - 가장 큰 free 블록 / 전체 free (64비트 나눗셈 없이 비율만 유지하며 축소)
+    // 블록 크기에는 구멍이 들어 있으므로 둘 다 구멍 포함 크기로 비교
+    uint32_t scaled_free = free_bytes;
+    uint32_t scaled_largest = largest_data;
+    while (scaled_free > 0xFFFFFFu) {
+        scaled_free >>= 1;
+        scaled_largest >>= 1;
+    }
+    uint32_t fragmentation = scaled_free ? 100 - scaled_largest * 100 / scaled_free : 0;
+
+    console_puts("[KMALLOC] Heap: ");
+    console_putu32(total_heap_size);
+    console_puts(" bytes mapped, ");
+    console_putu32(used_bytes);
+    console_puts(" used, ");
+    uint32_t holes = heap_hole_bytes();
+    console_putu32(free_bytes > holes ? free_bytes - holes : 0);
+    console_puts(" free, ");
+    console_putu32(holes);
+    console_puts(" in free blocks returned to PMM\n");
+    console_puts("[KMALLOC] Free blocks: ");
+    console_putu32(free_blocks);
+    console_puts(", largest ");
+    console_putu32(largest_data);
+    console_puts(" bytes, external fragmentation ");
+    console_putu32(fragmentation);
+    console_puts("%\n");
+
+    console_puts("[KMALLOC] Profile: ");
+    console_puts(profile_enabled ? "on, " : "off, ");
+    console_putu32(profile_tracked);
+    console_puts(" live allocations tracked, ");
+    console_putu32(profile_dropped);
+    console_puts(" dropped\n");
+    if (!profile_enabled && profile_tracked == 0) {
+        irq_restore(irq);
+        return;
+    }
+
+    console_puts("[KMALLOC] Size histogram (bytes: total allocs / live)\n");
+    for (uint32_t bin = 0; bin < PROFILE_HIST_BINS; bin++) {
+        if (profile_hist_total[bin] == 0) {
+            continue;
+        }
+        console_puts("[KMALLOC]   ");
+        console_putu32(1u << bin);
+        console_puts("-");
+        console_putu32((2u << bin) - 1);
+        console_puts(": ");
+        console_putu32(profile_hist_total[bin]);
+        console_puts(" / ");
+        console_putu32(profile_hist_live[bin]);
+        console_puts("\n");
+    }
+
+    // 호출 위치를 live 바이트 내림차순으로 (칸이 64개뿐이라 선택 정렬)
+    console_puts("[KMALLOC] Callsites (live bytes / live allocs / total allocs / peak bytes)\n");
+    uint64_t printed = 0;
+    for (;;) {
+        uint32_t best = PROFILE_SITE_COUNT;
+        for (uint32_t i = 0; i < PROFILE_SITE_COUNT; i++) {
+            if (!(printed & (1ull << i)) && profile_sites[i].total_count &&
+                (best == PROFILE_SITE_COUNT || profile_sites[i].live_bytes > profile_sites[best].live_bytes)) {
+                best = i;
+            }
+        }
+        if (best == PROFILE_SITE_COUNT) {
+            break;
+        }
+        printed |= 1ull << best;
+
+        const profile_site_t* site = &profile_sites[best];
+        console_puts("[KMALLOC]   ");
+        if (best == 0) {
+            console_puts("(other)");
+        } else {
+            console_puthex(site->addr);
+        }
+        console_puts(": ");
+        console_putu32(site->live_bytes);
+        console_puts(" / ");
+        console_putu32(site->live_count);
+        console_puts(" / ");
+        console_putu32(site->total_count);
+        console_puts(" / ");
+        console_putu32(site->peak_bytes);
+        console_puts("\n");
+    }
+
+    irq_restore(irq);
+}
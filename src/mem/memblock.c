@@ -0,0 +1,232 @@
+#include "mem/memblock.h"
+#include "mem/mmap.h"
+#include "mem/pmm.h"
+#include "mem/vmm.h"
+#include "drivers/console/console.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define MEMBLOCK_MAX_REGIONS 32u
+
+typedef struct memblock_region {
+    uint64_t base;
+    uint64_t size;
+} memblock_region_t;
+
+// 주소 오름차순, 서로 겹치거나 맞닿은 구간은 병합된 상태로 유지
+typedef struct memblock_type {
+    uint32_t count;
+    memblock_region_t regions[MEMBLOCK_MAX_REGIONS];
+} memblock_type_t;
+
+static memblock_type_t memblock_memory;
+static memblock_type_t memblock_reserved;
+
+// 커널 이미지의 적재(물리) 범위 (링크 주소는 higher-half라 linker.ld가 따로 정의)
+extern char kernel_phys_start;
+extern char kernel_phys_end;
+
+static struct multiboot_tag_mmap* find_mmap_tag(void* mbinfo) {
+    uint8_t* p = (uint8_t*)mbinfo + 8;
+
+    while (1) {
+        struct multiboot_tag* tag = (struct multiboot_tag*)p;
+
+        if (tag->type == MB2_TAG_TYPE_END) return NULL;
+        if (tag->type == MB2_TAG_TYPE_MMAP) return (struct multiboot_tag_mmap*)tag;
+
+        p += (tag->size + 7) & ~7u;
+    }
+}
+
+static void memblock_insert(memblock_type_t* type, uint64_t base, uint64_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    uint64_t end = base + size;
+    uint32_t i = 0;
+
+    // base보다 앞에서 끝나는 구간은 건너뜀
+    while (i < type->count && type->regions[i].base + type->regions[i].size < base) {
+        i++;
+    }
+
+    // 겹치거나 맞닿은 구간을 모두 흡수
+    uint32_t j = i;
+    while (j < type->count && type->regions[j].base <= end) {
+        uint64_t r_end = type->regions[j].base + type->regions[j].size;
+        if (type->regions[j].base < base) base = type->regions[j].base;
+        if (r_end > end) end = r_end;
+        j++;
+    }
+
+    if (i == j) {
+        // 새 구간 삽입
+        if (type->count >= MEMBLOCK_MAX_REGIONS) {
+            console_puts("[MEMBLOCK] Too many regions\n");
+            return;
+        }
+        for (uint32_t k = type->count; k > i; k--) {
+            type->regions[k] = type->regions[k - 1];
+        }
+        type->count++;
+    } else if (j - i > 1) {
+        // 흡수된 구간 [i + 1, j) 제거
+        uint32_t removed = j - i - 1;
+        for (uint32_t k = i + 1; k + removed < type->count; k++) {
+            type->regions[k] = type->regions[k + removed];
+        }
+        type->count -= removed;
+    }
+
+    type->regions[i].base = base;
+    type->regions[i].size = end - base;
+}
+
+void memblock_add(uint64_t base, uint64_t size) {
+    // usable 구간은 안쪽으로 페이지 정렬
+    uint64_t start = (base + PAGE_SIZE - 1) & ~(uint64_t)(PAGE_SIZE - 1);
+    uint64_t end = (base + size) & ~(uint64_t)(PAGE_SIZE - 1);
+
+    if (end > start) {
+        memblock_insert(&memblock_memory, start, end - start);
+    }
+}
+
+void memblock_reserve(uint64_t base, uint64_t size) {
+    // 예약 구간은 바깥쪽으로 페이지 정렬
+    uint64_t start = base & ~(uint64_t)(PAGE_SIZE - 1);
+    uint64_t end = (base + size + PAGE_SIZE - 1) & ~(uint64_t)(PAGE_SIZE - 1);
+
+    if (end > start) {
+        memblock_insert(&memblock_reserved, start, end - start);
+    }
+}
+
+void memblock_init(uint32_t magic, void* mbinfo) {
+    memblock_memory.count = 0;
+    memblock_reserved.count = 0;
+
+    if (magic != MB2_MAGIC) {
+        console_puts("[MEMBLOCK] Invalid magic\n");
+        return;
+    }
+
+    struct multiboot_tag_mmap* mm = find_mmap_tag(mbinfo);
+    if (!mm) {
+        console_puts("[MEMBLOCK] No memory map tag found\n");
+        return;
+    }
+
+    uint32_t entry_size = mm->entry_size;
+    if (entry_size == 0 || entry_size > 64) {
+        console_puts("[MEMBLOCK] Invalid entry size\n");
+        return;
+    }
+
+    uint8_t* p = (uint8_t*)mm + sizeof(*mm);
+    uint8_t* end = (uint8_t*)mm + mm->size;
+
+    while (p + sizeof(struct multiboot_mmap_entry) <= end) {
+        struct multiboot_mmap_entry* e = (struct multiboot_mmap_entry*)p;
+
+        if (e->type == 1) {
+            memblock_add(e->addr, e->len);
+        }
+
+        p += entry_size;
+    }
+
+    // 0~1MB (BIOS/VGA 영역), 커널 이미지(부팅 스택 포함), 멀티부트 정보 구조체
+    // mbinfo는 physmap 주소로 받음
+    memblock_reserve(0, 0x100000);
+    memblock_reserve((uint64_t)(uintptr_t)&kernel_phys_start,
+                     (uint64_t)((uintptr_t)&kernel_phys_end - (uintptr_t)&kernel_phys_start));
+    memblock_reserve(vmm_virt_to_phys(mbinfo), *(uint32_t*)mbinfo);
+}
+
+uint32_t memblock_alloc_range(uint32_t size, uint32_t align, uint64_t min_addr, uint64_t max_addr) {
+    if (size == 0) {
+        return 0;
+    }
+    if (align < PAGE_SIZE) {
+        align = PAGE_SIZE;
+    }
+    if (max_addr > 0x100000000ull) {
+        max_addr = 0x100000000ull;
+    }
+
+    uint64_t mask = (uint64_t)align - 1;
+    uint64_t length = ((uint64_t)size + PAGE_SIZE - 1) & ~(uint64_t)(PAGE_SIZE - 1);
+
+    // 낮은 주소부터 예약 구간을 피해 들어갈 자리 탐색
+    for (uint32_t i = 0; i < memblock_memory.count; i++) {
+        uint64_t r_base = memblock_memory.regions[i].base;
+        uint64_t r_end = r_base + memblock_memory.regions[i].size;
+        if (r_base < min_addr) {
+            r_base = min_addr;
+        }
+        uint64_t candidate = (r_base + mask) & ~mask;
+
+        for (uint32_t j = 0; j < memblock_reserved.count; j++) {
+            uint64_t res_base = memblock_reserved.regions[j].base;
+            uint64_t res_end = res_base + memblock_reserved.regions[j].size;
+
+            if (res_end <= candidate) continue;
+            if (res_base >= candidate + length) break;
+            candidate = (res_end + mask) & ~mask;
+        }
+
+        if (candidate + length <= r_end && candidate + length <= max_addr) {
+            memblock_insert(&memblock_reserved, candidate, length);
+            return (uint32_t)candidate;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t memblock_alloc(uint32_t size, uint32_t align) {
+    uint32_t addr = memblock_alloc_range(size, align, 0, MEMBLOCK_ALLOC_LIMIT);
+    if (!addr && size != 0) {
+        console_puts("[MEMBLOCK] Allocation failed\n");
+    }
+    return addr;
+}
+
+uint64_t memblock_start_of_memory(void) {
+    return memblock_memory.count ? memblock_memory.regions[0].base : 0;
+}
+
+uint64_t memblock_end_of_memory(void) {
+    if (memblock_memory.count == 0) {
+        return 0;
+    }
+    const memblock_region_t* last = &memblock_memory.regions[memblock_memory.count - 1];
+    return last->base + last->size;
+}
+
+void memblock_for_each_free_range(void (*fn)(uint64_t start, uint64_t end)) {
+    for (uint32_t i = 0; i < memblock_memory.count; i++) {
+        uint64_t cur = memblock_memory.regions[i].base;
+        uint64_t r_end = cur + memblock_memory.regions[i].size;
+
+        for (uint32_t j = 0; j < memblock_reserved.count && cur < r_end; j++) {
+            uint64_t res_base = memblock_reserved.regions[j].base;
+            uint64_t res_end = res_base + memblock_reserved.regions[j].size;
+
+            if (res_end <= cur) continue;
+            if (res_base >= r_end) break;
+            if (res_base > cur) {
+                fn(cur, res_base);
+            }
+            cur = res_end;
+        }
+
+        if (cur < r_end) {
+            fn(cur, r_end);
+        }
+    }
+}
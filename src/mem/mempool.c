@@ -0,0 +1,198 @@
+#include "mem/mempool.h"
+#include "mem/slab.h"
+#include "mem/kmalloc.h"
+#include "arch/x86/irqflags.h"
+#include "drivers/console/console.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// 예비 원소는 첫 워드에 다음 원소 포인터를 두는 단일 연결 LIFO 리스트
+// 원소는 풀마다 만든 slab 캐시에서 받으므로 refill/trim 비용도 객체당 O(1)
+
+typedef struct mempool_elem {
+    struct mempool_elem* next;
+} mempool_elem_t;
+
+struct mempool {
+    kmem_cache_t* cache;        // 원소 공급원 (프로세스 문맥에서만 사용)
+    mempool_elem_t* reserve;    // 예비 리스트
+    uint32_t available;
+    uint32_t in_use;
+    uint32_t min_nr;
+    uint32_t empty;
+    struct mempool* next;       // mempool_refill_all 대상 리스트
+};
+
+static mempool_t* pool_list = NULL;
+
+mempool_t* mempool_create(const char* name, size_t elem_size, uint32_t min_nr) {
+    if (elem_size == 0 || min_nr == 0) {
+        return NULL;
+    }
+    if (elem_size < sizeof(mempool_elem_t)) {
+        elem_size = sizeof(mempool_elem_t);
+    }
+
+    mempool_t* pool = (mempool_t*)kmalloc(sizeof(mempool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->cache = kmem_cache_create(name, elem_size, 0, NULL);
+    if (!pool->cache) {
+        kfree(pool);
+        return NULL;
+    }
+    pool->reserve = NULL;
+    pool->available = 0;
+    pool->in_use = 0;
+    pool->min_nr = min_nr;
+    pool->empty = 0;
+
+    mempool_refill(pool);
+    if (pool->available < min_nr) {
+        console_puts("[MEMPOOL] Failed to reserve elements for '");
+        console_puts(name ? name : "?");
+        console_puts("'\n");
+        mempool_destroy(pool);
+        return NULL;
+    }
+
+    uint32_t irq = irq_save();
+    pool->next = pool_list;
+    pool_list = pool;
+    irq_restore(irq);
+
+    return pool;
+}
+
+bool mempool_destroy(mempool_t* pool) {
+    if (!pool) {
+        return false;
+    }
+
+    uint32_t irq = irq_save();
+    if (pool->in_use != 0) {
+        irq_restore(irq);
+        console_puts("[MEMPOOL] Destroying pool with elements in use\n");
+        return false;
+    }
+
+    for (mempool_t** link = &pool_list; *link; link = &(*link)->next) {
+        if (*link == pool) {
+            *link = pool->next;
+            break;
+        }
+    }
+    mempool_elem_t* elem = pool->reserve;
+    pool->reserve = NULL;
+    pool->available = 0;
+    irq_restore(irq);
+
+    while (elem) {
+        mempool_elem_t* next = elem->next;
+        kmem_cache_free(pool->cache, elem);
+        elem = next;
+    }
+    kmem_cache_destroy(pool->cache);
+    kfree(pool);
+    return true;
+}
+
+void* mempool_alloc(mempool_t* pool) {
+    if (!pool) {
+        return NULL;
+    }
+
+    uint32_t irq = irq_save();
+    mempool_elem_t* elem = pool->reserve;
+    if (elem) {
+        pool->reserve = elem->next;
+        pool->available--;
+        pool->in_use++;
+    } else {
+        pool->empty++;
+    }
+    irq_restore(irq);
+
+    return elem;
+}
+
+void mempool_free(mempool_t* pool, void* elem) {
+    if (!pool || !elem) {
+        return;
+    }
+
+    // 예비분이 min_nr를 넘어도 여기서는 slab에 돌려주지 않음 (refill이 정리)
+    uint32_t irq = irq_save();
+    mempool_elem_t* node = (mempool_elem_t*)elem;
+    node->next = pool->reserve;
+    pool->reserve = node;
+    pool->available++;
+    pool->in_use--;
+    irq_restore(irq);
+}
+
+uint32_t mempool_refill(mempool_t* pool) {
+    if (!pool) {
+        return 0;
+    }
+
+    uint32_t moved = 0;
+
+    // 모자란 만큼 slab에서 받아 하나씩 push (slab 호출 동안은 인터럽트 허용)
+    while (pool->available < pool->min_nr) {
+        mempool_elem_t* elem = (mempool_elem_t*)kmem_cache_alloc(pool->cache);
+        if (!elem) {
+            break;
+        }
+        uint32_t irq = irq_save();
+        elem->next = pool->reserve;
+        pool->reserve = elem;
+        pool->available++;
+        irq_restore(irq);
+        moved++;
+    }
+
+    // 넘치는 원소는 slab으로 반환
+    for (;;) {
+        uint32_t irq = irq_save();
+        mempool_elem_t* elem = NULL;
+        if (pool->available > pool->min_nr) {
+            elem = pool->reserve;
+            pool->reserve = elem->next;
+            pool->available--;
+        }
+        irq_restore(irq);
+        if (!elem) {
+            break;
+        }
+        kmem_cache_free(pool->cache, elem);
+        moved++;
+    }
+
+    return moved;
+}
+
+// mempool_destroy가 idle 루프의 이 순회와 겹치지 않는다고 가정
+// (풀은 서브시스템 초기화 때 만들고 거의 해제하지 않음)
+uint32_t mempool_refill_all(void) {
+    uint32_t moved = 0;
+    for (mempool_t* pool = pool_list; pool; pool = pool->next) {
+        moved += mempool_refill(pool);
+    }
+    return moved;
+}
+
+uint32_t mempool_available(const mempool_t* pool) {
+    return pool ? pool->available : 0;
+}
+
+uint32_t mempool_in_use(const mempool_t* pool) {
+    return pool ? pool->in_use : 0;
+}
+
+uint32_t mempool_empty_count(const mempool_t* pool) {
+    return pool ? pool->empty : 0;
+}
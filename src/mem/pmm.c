@@ -1,453 +1,1168 @@
 #include "mem/pmm.h"
-#include "mem/mmap.h"
+#include "mem/page.h"
+#include "mem/memblock.h"
+#include "mem/vmm.h"
 #include "drivers/console/console.h"
+#include "arch/x86/tsc.h"
+#include "arch/x86/irqflags.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
 
+// 프레임 디스크립터 배열/버디 메타데이터는 실제 메모리 크기에 맞춰 memblock으로 할당
+// 디스크립터는 전체 페이지 인덱스 기준, 버디와 CPU 캐시는 zone마다 따로 둠
 static uint32_t total_pages = 0;
-static uint32_t free_pages = 0;
-static uint8_t g_bitmap[128 * 1024];
-static uint8_t* bitmap = NULL;
-static uint32_t bitmap_size = 0;
-static uint32_t memory_start = 0;
-static uint32_t memory_end = 0;
+static page_t* page_array = NULL;
+static uint64_t memory_start = 0;
+static uint64_t memory_end = 0;
+static uint32_t init_time_us = 0;
+// pmm_init 중 아직 free 구간으로 등록되지 않은 첫 페이지 (그 앞의 빈틈은 예약)
+static uint32_t init_next_idx = 0;
 
-extern char kernel_start;
-extern char kernel_end;
-static inline void bitmap_set(uint32_t page_idx) {
-    if (!bitmap || page_idx >= total_pages) return;
-    uint32_t byte_idx = page_idx / 8;
-    uint32_t bit_idx = page_idx % 8;
-    if (byte_idx >= bitmap_size) return;
-    bitmap[byte_idx] |= (1u << bit_idx);
+// size 바이트를 value로 채움 (rep stosb)
+static inline void pmm_fill_bytes(void* dst, uint8_t value, uint32_t size) {
+    __asm__ __volatile__ (
+        "cld\n\t"
+        "rep stosb\n\t"
+        : "+c" (size), "+D" (dst)
+        : "a" (value)
+        : "memory"
+    );
 }
 
-static inline void bitmap_clear(uint32_t page_idx) {
-    if (!bitmap || page_idx >= total_pages) return;
-    uint32_t byte_idx = page_idx / 8;
-    uint32_t bit_idx = page_idx % 8;
-    if (byte_idx >= bitmap_size) return;
-    bitmap[byte_idx] &= ~(1u << bit_idx);
+// 사용자에게 넘기기 직전 프레임 디스크립터를 할당 상태로 초기화
+static void pmm_pages_init_allocated(uint32_t page_idx, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        page_t* page = &page_array[page_idx + i];
+        page->flags = 0;
+        page->refcount = 1;
+        page->mapcount = 0;
+        page->private = 0;
+    }
 }
 
-static inline bool bitmap_get(uint32_t page_idx) {
-    if (!bitmap || page_idx >= total_pages) return true;
-    uint32_t byte_idx = page_idx / 8;
-    uint32_t bit_idx = page_idx % 8;
-    if (byte_idx >= bitmap_size) return true;
-    return (bitmap[byte_idx] & (1u << bit_idx)) != 0;
+// 펌웨어 영역/메모리 맵의 구멍/부팅 예약 구간
+static void pmm_pages_init_reserved(uint32_t start, uint32_t end) {
+    for (uint32_t i = start; i < end; i++) {
+        page_array[i].flags = PAGE_FLAG_RESERVED;
+        page_array[i].refcount = 1;
+    }
 }
 
-static struct multiboot_tag_mmap* find_mmap_tag(void* mbinfo) {
-    uint8_t* p = (uint8_t*)mbinfo + 8;
+// 버디 할당자: order별 free 블록 비트맵
+// free 페이지 자체에는 링크를 쓰지 않음 (HIGH zone 프레임은 physmap 밖이라 접근 불가)
+// order k 비트맵의 i번째 비트 = zone 안의 페이지 [i << k, (i + 1) << k) 블록이 free
+//
+// 각 order 비트맵은 3단계 요약 구조:
+//   level 0: 블록당 1비트
+//   level 1: level 0 워드(32블록)당 1비트 - 워드에 free 블록이 하나라도 있으면 1
+//   level 2: level 1 워드당 1비트
+// 검색은 32비트 워드 단위 + __builtin_ctz(bsf)로 수행하므로 메모리가 얼마나 차 있든 몇 번의 워드 읽기로 끝남
+// 할당 한 번은 free 블록이 있는 첫 order에서만 검색함 (다른 order는 free_count 비교 한 번)
+#define BUDDY_LEVELS 3u
 
-    while (1) {
-        struct multiboot_tag* tag = (struct multiboot_tag*)p;
+typedef struct buddy_order {
+    uint32_t* map[BUDDY_LEVELS];
+    uint32_t words[BUDDY_LEVELS];
+    uint32_t blocks;        // 이 order의 온전한 블록 수
+    uint32_t free_count;    // free 블록 수
+    uint32_t cursor;        // level 0 워드 커서: 직전 검색이 끝난 곳, 이 아래에는 free 블록 없음
+} buddy_order_t;
 
-        if (tag->type == MB2_TAG_TYPE_END) return NULL;
-        if (tag->type == MB2_TAG_TYPE_MMAP) return (struct multiboot_tag_mmap*)tag;
+// pages개 페이지를 관리하는 데 필요한 버디 비트맵 워드 수 (buddy_init과 같은 배치)
+static uint32_t buddy_metadata_words(uint32_t pages) {
+    uint32_t total = 0;
 
-        p += (tag->size + 7) & ~7u;
+    for (uint32_t order = 0; order <= PMM_MAX_ORDER; order++) {
+        uint32_t bits = pages >> order;
+        for (uint32_t level = 0; level < BUDDY_LEVELS; level++) {
+            uint32_t words = (bits + 31) / 32;
+            if (words == 0) words = 1;
+            total += words;
+            bits = words;
+        }
     }
+
+    return total;
 }
 
-void pmm_init(uint32_t magic, void* mbinfo) {
-    console_puts("[PMM] Starting initialization...\n");
-    
-    if (magic != MB2_MAGIC) {
-        console_puts("[PMM] Invalid magic\n");
-        return;
+// storage에서 pages개 페이지용 비트맵을 잘라 씀, 사용한 워드 수 반환
+static uint32_t buddy_init(buddy_order_t* orders, uint32_t pages, uint32_t* storage) {
+    uint32_t offset = 0;
+
+    for (uint32_t order = 0; order <= PMM_MAX_ORDER; order++) {
+        buddy_order_t* area = &orders[order];
+        uint32_t bits = pages >> order;
+
+        area->blocks = bits;
+        area->free_count = 0;
+        area->cursor = 0;
+
+        for (uint32_t level = 0; level < BUDDY_LEVELS; level++) {
+            uint32_t words = (bits + 31) / 32;
+            if (words == 0) words = 1;
+
+            area->map[level] = &storage[offset];
+            area->words[level] = words;
+            for (uint32_t w = 0; w < words; w++) {
+                area->map[level][w] = 0;
+            }
+
+            offset += words;
+            bits = words;
+        }
     }
 
-    struct multiboot_tag_mmap* mm = find_mmap_tag(mbinfo);
-    if (!mm) {
-        console_puts("[PMM] No memory map tag found\n");
-        return;
+    return offset;
+}
+
+static inline void buddy_mark_free(buddy_order_t* orders, uint32_t order, uint32_t block_idx) {
+    buddy_order_t* area = &orders[order];
+    uint32_t idx = block_idx;
+
+    // 하위 워드가 0에서 처음 1이 될 때만 상위 요약 비트를 켬
+    for (uint32_t level = 0; level < BUDDY_LEVELS; level++) {
+        uint32_t* word = &area->map[level][idx / 32];
+        bool was_empty = (*word == 0);
+        *word |= (1u << (idx % 32));
+        if (!was_empty) break;
+        idx /= 32;
     }
-    
-    console_puts("[PMM] Memory map found\n");
 
-    uint8_t* start = (uint8_t*)mm + sizeof(*mm);
-    uint8_t* end = (uint8_t*)mm + mm->size;
+    if (block_idx / 32 < area->cursor) {
+        area->cursor = block_idx / 32;
+    }
+    area->free_count++;
+}
 
-    uint32_t max_addr = 0;
-    uint32_t min_addr = UINT32_MAX;
-    bool found_usable_memory = false;
+static inline void buddy_mark_taken(buddy_order_t* orders, uint32_t order, uint32_t block_idx) {
+    buddy_order_t* area = &orders[order];
+    uint32_t idx = block_idx;
 
-    console_puts("[PMM] Scanning memory map...\n");
-    
-    uint32_t entry_size = mm->entry_size;
-    if (entry_size == 0 || entry_size > 64) {
-        console_puts("[PMM] Invalid entry size\n");
-        return;
+    // 하위 워드가 비었을 때만 상위 요약 비트를 끔
+    for (uint32_t level = 0; level < BUDDY_LEVELS; level++) {
+        uint32_t* word = &area->map[level][idx / 32];
+        *word &= ~(1u << (idx % 32));
+        if (*word != 0) break;
+        idx /= 32;
+    }
+
+    area->free_count--;
+}
+
+static inline bool buddy_is_free(const buddy_order_t* orders, uint32_t order, uint32_t block_idx) {
+    const buddy_order_t* area = &orders[order];
+    if (block_idx >= area->blocks) return false;
+    return (area->map[0][block_idx / 32] & (1u << (block_idx % 32))) != 0;
+}
+
+// level의 idx번째 비트보다 큰 위치에서 첫 번째 set 비트 (없으면 false)
+static bool buddy_find_next(const buddy_order_t* area, uint32_t level, uint32_t idx, uint32_t* out_idx) {
+    uint32_t w = idx / 32;
+    // idx 자신은 이미 비어 있다고 확인된 위치이므로 그 위 비트만 봄
+    uint32_t bits = area->map[level][w] & ~((2u << (idx % 32)) - 1);
+
+    while (bits == 0) {
+        if (level + 1 < BUDDY_LEVELS) {
+            // 같은 상위 워드 안에 없으면 상위 level에서 다음 비어있지 않은 워드를 찾음
+            if (!buddy_find_next(area, level + 1, w, &w)) {
+                return false;
+            }
+        } else if (++w >= area->words[level]) {
+            return false;
+        }
+        bits = area->map[level][w];
+    }
+
+    *out_idx = w * 32 + (uint32_t)__builtin_ctz(bits);
+    return true;
+}
+
+// order에서 가장 낮은 주소의 free 블록 찾기
+// 커서 워드부터 보고, 비어 있으면 요약 비트맵으로 다음 워드로 바로 건너뜀
+static bool buddy_find_lowest(buddy_order_t* orders, uint32_t order, uint32_t* out_block_idx) {
+    buddy_order_t* area = &orders[order];
+    if (area->free_count == 0) {
+        return false;
+    }
+
+    uint32_t w = area->cursor;
+    if (area->map[0][w] == 0 && !buddy_find_next(area, 1, w, &w)) {
+        return false;
+    }
+
+    area->cursor = w;
+    *out_block_idx = w * 32 + (uint32_t)__builtin_ctz(area->map[0][w]);
+    return true;
+}
+
+// order에서 first_block 이상인 첫 free 블록 찾기 (커서는 건드리지 않음)
+static bool buddy_find_from(const buddy_order_t* orders, uint32_t order, uint32_t first_block,
+                            uint32_t* out_block_idx) {
+    const buddy_order_t* area = &orders[order];
+    if (area->free_count == 0 || first_block >= area->blocks) {
+        return false;
     }
-    
-    uint8_t* p = start;
-    uint32_t entry_count = 0;
-    
-    // Process all memory map entries, bounded by 'end' pointer
-    // No arbitrary limit - rely on bounds checking against 'end'
-    while (p < end) {
-        if (p + sizeof(struct multiboot_mmap_entry) > end) {
+    if (buddy_is_free(orders, order, first_block)) {
+        *out_block_idx = first_block;
+        return true;
+    }
+    return buddy_find_next(area, 0, first_block, out_block_idx) && *out_block_idx < area->blocks;
+}
+
+// 2^order 페이지 블록 할당 후 버디 인덱스(첫 페이지) 반환
+// 요청 order부터 올라가며 free 블록이 있는 첫 order를 쓰고, 그 order 안에서는 가장 낮은 주소 블록
+// 이미 쪼개진 작은 블록부터 소비해야 큰 블록이 쪼개지지 않고 남아 연속 할당이 계속 성공함
+// 큰 블록을 쪼갠 경우 남는 절반들은 하위 order로 되돌림
+// min_page를 주면 그 버디 인덱스 이상에 있는 블록만 고름 (0이면 zone 전체)
+static bool buddy_alloc_block(buddy_order_t* orders, uint32_t order, uint32_t min_page, uint32_t* out_page_idx) {
+    uint32_t best_order = order;
+    uint32_t best_block;
+
+    // 빈 order는 free_count만 보고 건너뜀 -> 비트맵 검색은 고른 order 하나에서 한 번만
+    for (;; best_order++) {
+        while (best_order <= PMM_MAX_ORDER && orders[best_order].free_count == 0) {
+            best_order++;
+        }
+        if (best_order > PMM_MAX_ORDER) {
+            return false;
+        }
+
+        if (min_page == 0) {
+            if (!buddy_find_lowest(orders, best_order, &best_block)) {
+                return false;
+            }
             break;
         }
-        
-        struct multiboot_mmap_entry* e = (struct multiboot_mmap_entry*)p;
-
-        if (e->type == 1) {
-            uint32_t addr_low = (uint32_t)e->addr;
-            uint32_t addr_high = (uint32_t)(e->addr >> 32);
-            uint32_t len_low = (uint32_t)e->len;
-            uint32_t len_high = (uint32_t)(e->len >> 32);
-            
-            // Only process 32-bit addresses
-            if (addr_high == 0 && len_high == 0) {
-                uint32_t entry_start = addr_low;
-                uint32_t entry_end = addr_low + len_low;
-
-                if (entry_end < entry_start) {
-                    entry_end = UINT32_MAX;
-                }
-
-                found_usable_memory = true;
-
-                if (entry_start < min_addr) {
-                    min_addr = entry_start;
-                }
-                if (entry_end > max_addr) {
-                    max_addr = entry_end;
-                }
+        // 하한이 있으면 이 order에 그 위 블록이 없을 수 있으므로 다음 order로 계속
+        uint32_t first = (min_page + (1u << best_order) - 1) >> best_order;
+        if (buddy_find_from(orders, best_order, first, &best_block)) {
+            break;
+        }
+    }
+
+    buddy_mark_taken(orders, best_order, best_block);
+
+    // 큰 블록을 쪼개서 뒤쪽 절반(buddy)은 free로 남김
+    while (best_order > order) {
+        best_order--;
+        best_block <<= 1;
+        buddy_mark_free(orders, best_order, best_block + 1);
+    }
+
+    *out_page_idx = best_block << order;
+    return true;
+}
+
+// 최대 order 블록을 연속으로 이어 붙여 count 페이지 확보 (4MB 초과 요청용)
+static bool buddy_alloc_run(buddy_order_t* orders, uint32_t count, uint32_t* out_page_idx) {
+    uint32_t blocks_needed = (count + (1u << PMM_MAX_ORDER) - 1) >> PMM_MAX_ORDER;
+    uint32_t run = 0;
+    uint32_t run_start = 0;
+
+    for (uint32_t i = 0; i < orders[PMM_MAX_ORDER].blocks; i++) {
+        if (!buddy_is_free(orders, PMM_MAX_ORDER, i)) {
+            run = 0;
+            continue;
+        }
+        if (run == 0) {
+            run_start = i;
+        }
+        if (++run == blocks_needed) {
+            for (uint32_t j = 0; j < blocks_needed; j++) {
+                buddy_mark_taken(orders, PMM_MAX_ORDER, run_start + j);
             }
+            *out_page_idx = run_start << PMM_MAX_ORDER;
+            return true;
         }
-        
-        p += entry_size;
-        entry_count++;
     }
 
-    console_puts("[PMM] Memory scan complete (");
-    if (entry_count > 0) {
-        uint32_t ec = entry_count;
-        char buf[12];
-        int idx = 0;
-        while (ec > 0 && idx < 11) {
-            buf[idx++] = (char)('0' + (ec % 10));
-            ec /= 10;
+    return false;
+}
+
+// 블록 반환 + buddy가 free면 상위 order로 병합 반복
+static void buddy_free_block(buddy_order_t* orders, uint32_t page_idx, uint32_t order) {
+    uint32_t block_idx = page_idx >> order;
+
+    while (order < PMM_MAX_ORDER) {
+        uint32_t buddy_idx = block_idx ^ 1u;
+        if (!buddy_is_free(orders, order, buddy_idx)) {
+            break;
+        }
+        buddy_mark_taken(orders, order, buddy_idx);
+        block_idx >>= 1;
+        order++;
+    }
+
+    buddy_mark_free(orders, order, block_idx);
+}
+
+// 페이지 구간 [start, end)를 정렬된 최대 크기 블록들로 나눠 버디에 반환
+// 호출자가 free_pages를 먼저 갱신해야 함
+static void buddy_free_range(buddy_order_t* orders, uint32_t start, uint32_t end) {
+    while (start < end) {
+        uint32_t order = PMM_MAX_ORDER;
+        if (start != 0 && (uint32_t)__builtin_ctz(start) < order) {
+            order = (uint32_t)__builtin_ctz(start);
+        }
+        while ((1u << order) > end - start) {
+            order--;
+        }
+
+        buddy_free_block(orders, start, order);
+        start += 1u << order;
+    }
+}
+
+static void console_putu32(uint32_t v) {
+    char buf[11];
+    int idx = 0;
+
+    if (v == 0) {
+        console_putc('0');
+        return;
+    }
+
+    while (v > 0 && idx < 10) {
+        buf[idx++] = (char)('0' + (v % 10));
+        v /= 10;
+    }
+
+    while (idx--) {
+        console_putc(buf[idx]);
+    }
+}
+
+// per-CPU 프레임 캐시 (매거진)
+// 단일 페이지 할당/해제는 CPU별 캐시에서 처리하고, 전역 비트맵/버디는 배치 단위로만 건드림
+// 캐시에 있는 프레임은 버디 입장에서 사용 중이며 zone의 free_pages에는 포함되지 않음 (디스크립터는 free)
+//   - 비어 있으면 PMM_PCP_BATCH개를 한 번에 채움
+//   - PMM_PCP_HIGH에 도달하면 PMM_PCP_LOW까지 전역으로 반환
+#define PMM_MAX_CPUS 1u
+#define PMM_PCP_HIGH 64u
+#define PMM_PCP_LOW 32u
+#define PMM_PCP_BATCH_ORDER 4u
+#define PMM_PCP_BATCH (1u << PMM_PCP_BATCH_ORDER)
+
+typedef struct pmm_pcp {
+    uint32_t count;
+    uint32_t frames[PMM_PCP_HIGH];  // 페이지 인덱스 스택
+} pmm_pcp_t;
+
+// 메모리 zone: 물리 주소 구간마다 독립된 버디와 CPU 캐시
+//   DMA    [1MB, 16MB)           ISA DMA 가능
+//   NORMAL [16MB, 512MB)         커널이 physmap으로 직접 매핑하는 저위 메모리
+//   HIGH   [512MB, 끝)           직접 매핑 밖, vmm_map_phys로 매핑해서 사용
+// 할당은 요청한 가장 높은 zone부터 시작해 낮은 zone으로만 fallback
+typedef struct pmm_zone {
+    const char* name;
+    uint32_t start;         // 전역 페이지 인덱스 [start, end)
+    uint32_t end;
+    uint32_t buddy_base;    // 버디 인덱스 0의 절대 PFN (2^PMM_MAX_ORDER 정렬)
+    uint32_t free_pages;    // 버디에 있는 free 페이지 (CPU 캐시 제외)
+    buddy_order_t orders[PMM_MAX_ORDER + 1];
+    pmm_pcp_t pcp[PMM_MAX_CPUS];
+} pmm_zone_t;
+
+static pmm_zone_t pmm_zones[PMM_ZONE_COUNT] = {
+    [PMM_ZONE_ID_DMA] = { .name = "DMA" },
+    [PMM_ZONE_ID_NORMAL] = { .name = "Normal" },
+    [PMM_ZONE_ID_HIGH] = { .name = "High" },
+};
+
+// 물리 주소 경계를 페이지 인덱스로 (관리 범위로 잘라냄)
+static uint32_t pmm_phys_to_boundary(uint64_t phys) {
+    if (phys <= memory_start) return 0;
+    if (phys >= memory_end) return total_pages;
+    return (uint32_t)((phys - memory_start) >> 12);
+}
+
+// 버디 인덱스는 절대 PFN 기준이라 order 블록이 물리 주소로도 자연 정렬됨
+// (zone 시작이 1MB처럼 정렬되지 않아도 버디 쌍과 정렬 검사는 물리 주소와 일치)
+// buddy_base 앞쪽의 없는 페이지는 버디에 등록되지 않으므로 병합 상대가 되지 않음
+static inline uint32_t pmm_zone_buddy_idx(const pmm_zone_t* zone, uint32_t page_idx) {
+    return (uint32_t)(memory_start >> 12) + page_idx - zone->buddy_base;
+}
+
+static inline uint32_t pmm_zone_page_idx(const pmm_zone_t* zone, uint32_t buddy_idx) {
+    return zone->buddy_base + buddy_idx - (uint32_t)(memory_start >> 12);
+}
+
+// zone 버디가 관리하는 인덱스 수 (buddy_base부터 zone 끝까지)
+static inline uint32_t pmm_zone_buddy_pages(const pmm_zone_t* zone) {
+    return pmm_zone_buddy_idx(zone, zone->end);
+}
+
+static inline pmm_zone_t* pmm_zone_of(uint32_t page_idx) {
+    if (page_idx < pmm_zones[PMM_ZONE_ID_DMA].end) return &pmm_zones[PMM_ZONE_ID_DMA];
+    if (page_idx < pmm_zones[PMM_ZONE_ID_NORMAL].end) return &pmm_zones[PMM_ZONE_ID_NORMAL];
+    return &pmm_zones[PMM_ZONE_ID_HIGH];
+}
+
+// 할당 플래그가 허용하는 가장 높은 zone
+static inline uint32_t pmm_zone_top(uint32_t flags) {
+    if (flags & PMM_ZONE_HIGH) return PMM_ZONE_ID_HIGH;
+    if (flags & PMM_ZONE_DMA) return PMM_ZONE_ID_DMA;
+    return PMM_ZONE_ID_NORMAL;
+}
+
+// 초기화 시 usable 구간 [start, end)를 zone 버디에 등록
+// 직전 free 구간과의 사이는 예약 구간으로 디스크립터에 표시
+static void pmm_init_free_range(uint32_t start, uint32_t end) {
+    if (start >= end) {
+        return;
+    }
+
+    pmm_pages_init_reserved(init_next_idx, start);
+    init_next_idx = end;
+
+    for (uint32_t z = 0; z < PMM_ZONE_COUNT; z++) {
+        pmm_zone_t* zone = &pmm_zones[z];
+        uint32_t s = start > zone->start ? start : zone->start;
+        uint32_t e = end < zone->end ? end : zone->end;
+        if (s >= e) {
+            continue;
         }
-        while (idx--) console_putc(buf[idx]);
+
+        zone->free_pages += e - s;
+        buddy_free_range(zone->orders, pmm_zone_buddy_idx(zone, s), pmm_zone_buddy_idx(zone, e));
+    }
+}
+
+// memblock이 넘겨준 free 물리 구간을 페이지 인덱스로 바꿔 등록
+static void pmm_init_free_phys_range(uint64_t start, uint64_t end) {
+    if (start < memory_start) start = memory_start;
+    if (end > memory_end) end = memory_end;
+    if (end <= start) {
+        return;
+    }
+
+    pmm_init_free_range((uint32_t)((start - memory_start) >> 12),
+                        (uint32_t)((end - memory_start) >> 12));
+}
+
+void pmm_init(void) {
+    uint64_t init_start_tsc = tsc_read();
+
+    uint64_t ram_start = memblock_start_of_memory();
+    uint64_t ram_end = memblock_end_of_memory();
+
+    // 4GB 위 메모리도 관리 (PAE로 매핑), 페이지 인덱스가 32비트에 들어가는 범위까지만
+    if (ram_end > PMM_MAX_PHYS_ADDR) {
+        ram_end = PMM_MAX_PHYS_ADDR;
     }
-    console_puts(" entries processed)\n");
-    
-    if (!found_usable_memory || max_addr == 0) {
+
+    // PAE를 쓸 수 없으면 4GB 위 프레임은 매핑할 방법이 없으므로 관리하지 않음
+    if (ram_end > PMM_LOW_LIMIT &&
+        (!vmm_cpu_has_pae() || vmm_get_paging_mode() == VMM_PAGING_LEGACY)) {
+        console_puts("[PMM] Ignoring memory above 4GB (no PAE)\n");
+        ram_end = PMM_LOW_LIMIT;
+    }
+
+    if (ram_end <= ram_start) {
         console_puts("[PMM] No usable memory found\n");
         return;
     }
 
-    console_puts("[PMM] Aligning memory...\n");
-    
-    uint32_t page_mask_32 = ~(PAGE_SIZE - 1);
-    
-    uint32_t mem_start_32 = (min_addr + PAGE_SIZE - 1) & page_mask_32;
-    
+    uint64_t page_mask = ~(uint64_t)(PAGE_SIZE - 1);
+    uint64_t mem_start = (ram_start + PAGE_SIZE - 1) & page_mask;
+
     // Exclude 0~1MB from PMM management (standard approach)
-    const uint32_t PMM_MIN_ADDR = 0x100000;
-    if (mem_start_32 < PMM_MIN_ADDR) {
-        mem_start_32 = PMM_MIN_ADDR;
+    const uint64_t PMM_MIN_ADDR = 0x100000;
+    if (mem_start < PMM_MIN_ADDR) {
+        mem_start = PMM_MIN_ADDR;
     }
-    
-    uint32_t mem_end_32 = max_addr & page_mask_32;
 
-    if (mem_end_32 <= mem_start_32) {
+    uint64_t mem_end = ram_end & page_mask;
+
+    if (mem_end <= mem_start) {
         console_puts("[PMM] Invalid memory range\n");
         return;
     }
-    
-    memory_start = mem_start_32;
-    memory_end = mem_end_32;
-
-    uint32_t mem_diff_32 = mem_end_32 - mem_start_32;
-    total_pages = mem_diff_32 >> 12;
-    
-    if (total_pages > 0x100000) {
-        total_pages = 0x100000;
-    }
-    
-    console_puts("[PMM] Page count calculated\n");
-    
-    bitmap_size = (total_pages + 7) / 8;
-    
-    console_puts("[PMM] Memory range calculated\n");
-
-    console_puts("[PMM] Calculating kernel region...\n");
-    
-    uint32_t kernel_start_addr = (uint32_t)(uintptr_t)&kernel_start;
-    uint32_t kernel_end_addr = (uint32_t)(uintptr_t)&kernel_end;
-    
-    uint32_t kernel_start_page = 0;
-    uint32_t kernel_end_page = 0;
-    
-    if (kernel_start_addr >= memory_start && kernel_start_addr < memory_end) {
-        uint32_t kernel_offset = kernel_start_addr - memory_start;
-        kernel_start_page = kernel_offset >> 12;
-        
-        uint32_t kernel_end_offset = kernel_end_addr - memory_start;
-        kernel_end_page = (kernel_end_offset + PAGE_SIZE - 1) >> 12;
-        if (kernel_end_page > total_pages) {
-            kernel_end_page = total_pages;
-        }
-    }
-    
-    console_puts("[PMM] Kernel region calculated\n");
-
-    bitmap = g_bitmap;
-    
-    uint32_t max_bitmap_size = sizeof(g_bitmap);
-    if (bitmap_size > max_bitmap_size) {
-        console_puts("[PMM] Bitmap size exceeds static allocation\n");
-        bitmap_size = max_bitmap_size;
-        total_pages = max_bitmap_size * 8;
-    }
-
-    console_puts("[PMM] Bitmap initialized (static allocation)\n");
-
-    // Initialize bitmap to 0xFF (all pages marked as used)
-    // BSS initializes to 0, but 0 means free in our semantics, so we need to set all to used first
-    if (bitmap != NULL && bitmap_size > 0) {
-        uint8_t* bmp = bitmap;
-        uint32_t size = bitmap_size;
-        
-        __asm__ __volatile__ (
-            "cld\n\t"
-            "rep stosb\n\t"
-            : "+c" (size), "+D" (bmp)
-            : "a" (0xFF)
-            : "memory"
-        );
-    }
-    console_puts("[PMM] Bitmap set to all used (0xFF)\n");
-
-    // 커널 영역을 명시적으로 사용 중으로 마킹
-    if (kernel_end_page > 0) {
-        console_puts("[PMM] Marking kernel region as used...\n");
-        for (uint32_t page_idx = kernel_start_page; page_idx < kernel_end_page && page_idx < total_pages; page_idx++) {
-            bitmap_set(page_idx);
-        }
-        console_puts("[PMM] Kernel region marked as used\n");
-    }
-
-    console_puts("[PMM] Marking free pages...\n");
-    
-    free_pages = 0;
-    p = start;
-    entry_count = 0;
-    // Process all memory map entries, bounded by 'end' pointer
-    // No arbitrary limit - rely on bounds checking against 'end'
-    while (p < end) {
-        if (p + sizeof(struct multiboot_mmap_entry) > end) {
-            break;
-        }
-        
-        struct multiboot_mmap_entry* e = (struct multiboot_mmap_entry*)p;
-
-        if (e->type == 1) {
-            uint32_t addr_low = (uint32_t)e->addr;
-            uint32_t addr_high = (uint32_t)(e->addr >> 32);
-            uint32_t len_low = (uint32_t)e->len;
-            uint32_t len_high = (uint32_t)(e->len >> 32);
-            
-            if (addr_high == 0 && len_high == 0) {
-                uint32_t entry_start_32 = addr_low;
-                uint32_t entry_end_32 = addr_low + len_low;
-                uint32_t entry_start_aligned = (entry_start_32 + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
-                uint32_t entry_end_aligned = entry_end_32 & ~(PAGE_SIZE - 1);
-
-                if (entry_end_aligned > entry_start_aligned) {
-                    if (entry_start_aligned < memory_start) entry_start_aligned = memory_start;
-                    if (entry_end_aligned > memory_end) entry_end_aligned = memory_end;
-
-                    uint32_t page_start_offset = entry_start_aligned - memory_start;
-                    uint32_t page_end_offset = entry_end_aligned - memory_start;
-                    uint32_t page_start = page_start_offset >> 12;
-                    uint32_t page_end = page_end_offset >> 12;
-
-                    for (uint32_t page_idx = page_start; page_idx < page_end && page_idx < total_pages; page_idx++) {
-                        // 커널 영역은 사용 중으로 마킹 (할당 불가)
-                        // kernel_start_page가 0일 수 있으므로 kernel_end_page만 체크
-                        if (kernel_end_page > 0 && 
-                            page_idx >= kernel_start_page && page_idx < kernel_end_page) {
-                            continue;
-                        }
-
-                        if (bitmap != NULL) {
-                            bitmap_clear(page_idx);
-                            free_pages++;
-                        }
-                    }
-                }
-            }
+
+    memory_start = mem_start;
+    memory_end = mem_end;
+    total_pages = (uint32_t)((mem_end - mem_start) >> 12);
+
+    // zone 경계
+    pmm_zones[PMM_ZONE_ID_DMA].start = 0;
+    pmm_zones[PMM_ZONE_ID_DMA].end = pmm_phys_to_boundary(PMM_DMA_LIMIT);
+    pmm_zones[PMM_ZONE_ID_NORMAL].start = pmm_zones[PMM_ZONE_ID_DMA].end;
+    pmm_zones[PMM_ZONE_ID_NORMAL].end = pmm_phys_to_boundary(PMM_NORMAL_LIMIT);
+    pmm_zones[PMM_ZONE_ID_HIGH].start = pmm_zones[PMM_ZONE_ID_NORMAL].end;
+    pmm_zones[PMM_ZONE_ID_HIGH].end = total_pages;
+    for (uint32_t z = 0; z < PMM_ZONE_COUNT; z++) {
+        uint32_t start_pfn = (uint32_t)(memory_start >> 12) + pmm_zones[z].start;
+        pmm_zones[z].buddy_base = start_pfn & ~((1u << PMM_MAX_ORDER) - 1);
+    }
+
+    // 메타데이터: [프레임 디스크립터 배열][zone별 버디 비트맵]
+    // 디스크립터 배열이 크므로 DMA zone을 아끼도록 16MB 위(직접 매핑되는 NORMAL)를 먼저 시도
+    uint32_t page_array_bytes = total_pages * (uint32_t)sizeof(page_t);
+    uint32_t metadata_size = page_array_bytes;
+    for (uint32_t z = 0; z < PMM_ZONE_COUNT; z++) {
+        metadata_size += buddy_metadata_words(pmm_zone_buddy_pages(&pmm_zones[z])) * 4;
+    }
+
+    uint32_t metadata = memblock_alloc_range(metadata_size, PAGE_SIZE, PMM_DMA_LIMIT, PMM_NORMAL_LIMIT);
+    if (!metadata) {
+        metadata = memblock_alloc(metadata_size, PAGE_SIZE);
+    }
+    if (!metadata) {
+        console_puts("[PMM] Failed to allocate metadata\n");
+        total_pages = 0;
+        return;
+    }
+
+    // 모든 디스크립터를 0(free)으로 시작하고, free 구간 사이의 빈틈만 예약으로 표시
+    // 부팅 페이지 디렉토리가 이미 physmap 범위를 매핑해 둠
+    page_array = (page_t*)vmm_phys_to_virt(metadata);
+    pmm_fill_bytes(page_array, 0, page_array_bytes);
+    init_next_idx = 0;
+
+    uint32_t* buddy_storage = (uint32_t*)((uint8_t*)page_array + page_array_bytes);
+    for (uint32_t z = 0; z < PMM_ZONE_COUNT; z++) {
+        pmm_zone_t* zone = &pmm_zones[z];
+        buddy_storage += buddy_init(zone->orders, pmm_zone_buddy_pages(zone), buddy_storage);
+        zone->free_pages = 0;
+        for (uint32_t cpu = 0; cpu < PMM_MAX_CPUS; cpu++) {
+            zone->pcp[cpu].count = 0;
         }
-        
-        p += entry_size;
-        entry_count++;
     }
 
+    // 커널 이미지, 멀티부트 정보, 방금 할당한 메타데이터는 memblock에서 예약되어 있음
+    memblock_for_each_free_range(pmm_init_free_phys_range);
+    pmm_pages_init_reserved(init_next_idx, total_pages);
+
+    console_puts("[PMM] Metadata: ");
+    console_putu32((metadata_size + 1023) / 1024);
+    console_puts(" KiB\n");
+
+    init_time_us = tsc_cycles_to_us(tsc_read() - init_start_tsc);
+
     console_puts("[PMM] Initialized: ");
-    if (total_pages > 0) {
-        uint32_t t = total_pages;
-        char buf[12];
-        int idx = 0;
-        while (t > 0 && idx < 11) {
-            buf[idx++] = (char)('0' + (t % 10));
-            t /= 10;
+    console_putu32(total_pages);
+    console_puts(" total pages, ");
+    console_putu32(pmm_get_free_pages());
+    console_puts(" free pages (");
+    console_putu32(init_time_us);
+    console_puts(" us)\n");
+
+    for (uint32_t z = 0; z < PMM_ZONE_COUNT; z++) {
+        const pmm_zone_t* zone = &pmm_zones[z];
+        if (zone->end == zone->start) {
+            continue;
         }
-        while (idx--) console_putc(buf[idx]);
+        console_puts("[PMM] Zone ");
+        console_puts(zone->name);
+        console_puts(": ");
+        console_putu32(zone->end - zone->start);
+        console_puts(" pages, ");
+        console_putu32(zone->free_pages);
+        console_puts(" free\n");
     }
-    console_puts(" total pages, ");
-    if (free_pages > 0) {
-        uint32_t f = free_pages;
-        char buf[12];
-        int idx = 0;
-        while (f > 0 && idx < 11) {
-            buf[idx++] = (char)('0' + (f % 10));
-            f /= 10;
+}
+
+static inline uint64_t pmm_idx_to_phys(uint32_t page_idx) {
+    return memory_start + ((uint64_t)page_idx << 12);
+}
+
+// void* API는 physmap 주소를 주고받음 (DMA/NORMAL zone은 모두 physmap 안)
+static inline void* pmm_idx_to_ptr(uint32_t page_idx) {
+    return vmm_phys_to_virt(pmm_idx_to_phys(page_idx));
+}
+
+// 관리 범위 안의 페이지 정렬된 물리 주소를 페이지 인덱스로 변환
+static bool pmm_phys_to_idx(uint64_t phys, uint32_t* out_page_idx) {
+    if (phys < memory_start || phys >= memory_end) {
+        return false;
+    }
+
+    if ((phys & 0xFFF) != 0) {
+        return false;
+    }
+
+    *out_page_idx = (uint32_t)((phys - memory_start) >> 12);
+    return *out_page_idx < total_pages;
+}
+
+// zone 버디에서 2^order 블록을 꺼내 사용 중으로 마킹 (전역 페이지 인덱스 반환)
+static bool pmm_take_block(pmm_zone_t* zone, uint32_t order, uint32_t* out_page_idx) {
+    uint32_t buddy_idx;
+    if (zone->free_pages < (1u << order) || !buddy_alloc_block(zone->orders, order, 0, &buddy_idx)) {
+        return false;
+    }
+
+    *out_page_idx = pmm_zone_page_idx(zone, buddy_idx);
+    zone->free_pages -= 1u << order;
+    return true;
+}
+
+// 전역 페이지 인덱스 min_page_idx 이상에서 2^order 블록을 꺼냄 (CPU 캐시를 거치지 않음)
+static bool pmm_take_block_above(pmm_zone_t* zone, uint32_t order, uint32_t min_page_idx,
+                                 uint32_t* out_page_idx) {
+    uint32_t buddy_idx;
+    if (zone->free_pages < (1u << order) || min_page_idx >= zone->end ||
+        !buddy_alloc_block(zone->orders, order, pmm_zone_buddy_idx(zone, min_page_idx), &buddy_idx)) {
+        return false;
+    }
+
+    *out_page_idx = pmm_zone_page_idx(zone, buddy_idx);
+    zone->free_pages -= 1u << order;
+    return true;
+}
+
+// 사용 중인 페이지 구간을 free로 되돌리고 zone 버디에 병합
+static void pmm_release_pages(pmm_zone_t* zone, uint32_t start_idx, uint32_t count) {
+    zone->free_pages += count;
+    uint32_t buddy_idx = pmm_zone_buddy_idx(zone, start_idx);
+    buddy_free_range(zone->orders, buddy_idx, buddy_idx + count);
+}
+
+// 현재 CPU 슬롯 (SMP 전까지는 항상 0)
+static inline pmm_pcp_t* pmm_this_cpu_cache(pmm_zone_t* zone) {
+    return &zone->pcp[0];
+}
+
+static void pmm_pcp_refill(pmm_zone_t* zone, pmm_pcp_t* pcp) {
+    uint32_t start_idx;
+
+    // 배치 크기 블록 하나로 채우는 것이 가장 싸고, 안 되면 한 장씩
+    if (pmm_take_block(zone, PMM_PCP_BATCH_ORDER, &start_idx)) {
+        for (uint32_t i = PMM_PCP_BATCH; i > 0; i--) {
+            pcp->frames[pcp->count++] = start_idx + i - 1;
+        }
+    } else {
+        while (pcp->count < PMM_PCP_BATCH && pmm_take_block(zone, 0, &start_idx)) {
+            pcp->frames[pcp->count++] = start_idx;
         }
-        while (idx--) console_putc(buf[idx]);
     }
-    console_puts(" free pages\n");
 }
 
-void* pmm_alloc_page(void) {
-    if (!bitmap || free_pages == 0) {
-        return NULL;
+static void pmm_pcp_drain(pmm_zone_t* zone, pmm_pcp_t* pcp, uint32_t keep) {
+    while (pcp->count > keep) {
+        pmm_release_pages(zone, pcp->frames[--pcp->count], 1);
+    }
+}
+
+// 미리 0으로 채워 둔 프레임 풀
+// kernel_idle_loop가 남는 시간에 채우고, pmm_alloc_zeroed_page는 스택에서 꺼내기만 함
+// 풀에 있는 프레임은 버디 입장에서 사용 중이고, 디스크립터는 free이며 pmm_get_free_pages에도 포함됨
+#define PMM_ZERO_POOL_SIZE 64u
+
+// idle 태스크도 선점되는 PMM 사용자이므로 풀 스택 push/pop은 irq_save 안에서 하고,
+// 풀을 채우거나 되돌릴 때의 버디/CPU 캐시 접근은 irq_save로 막힌 공개 함수로만 함
+static struct {
+    uint32_t count;
+    uint32_t frames[PMM_ZERO_POOL_SIZE];  // 페이지 인덱스 스택
+    uint32_t hits;
+    uint32_t misses;
+} zero_pool;
+
+// 4KB 프레임을 0으로 채움 (rep stosl)
+static inline void pmm_zero_frame(void* page) {
+    uint32_t count = PAGE_SIZE / 4;
+    __asm__ __volatile__ (
+        "cld\n\t"
+        "rep stosl\n\t"
+        : "+c" (count), "+D" (page)
+        : "a" (0)
+        : "memory"
+    );
+}
+
+// 연속 할당이 실패했을 때 캐시에 묶인 프레임을 풀어 병합 기회를 줌
+// 호출자가 irq_save 상태여야 함
+static bool pmm_drain_all_caches(void) {
+    bool drained = false;
+
+    while (zero_pool.count > 0) {
+        uint32_t page_idx = zero_pool.frames[--zero_pool.count];
+        pmm_release_pages(pmm_zone_of(page_idx), page_idx, 1);
+        drained = true;
+    }
+
+    for (uint32_t z = 0; z < PMM_ZONE_COUNT; z++) {
+        for (uint32_t cpu = 0; cpu < PMM_MAX_CPUS; cpu++) {
+            if (pmm_zones[z].pcp[cpu].count > 0) {
+                pmm_pcp_drain(&pmm_zones[z], &pmm_zones[z].pcp[cpu], 0);
+                drained = true;
+            }
+        }
+    }
+
+    return drained;
+}
+
+// zone의 CPU 캐시에서 프레임 하나 (비어 있으면 버디에서 배치로 채움)
+static bool pmm_zone_alloc_frame(pmm_zone_t* zone, uint32_t* out_page_idx) {
+    pmm_pcp_t* pcp = pmm_this_cpu_cache(zone);
+    if (pcp->count == 0) {
+        pmm_pcp_refill(zone, pcp);
+        if (pcp->count == 0) {
+            return false;
+        }
     }
 
-    for (uint32_t i = 0; i < total_pages; i++) {
-        if (!bitmap_get(i)) {
-            bitmap_set(i);
-            free_pages--;
-            return (void*)(uintptr_t)(memory_start + i * PAGE_SIZE);
+    *out_page_idx = pcp->frames[--pcp->count];
+    return true;
+}
+
+// 프레임 참조 하나 해제, 마지막 참조였으면 소속 zone의 CPU 캐시로 반환
+// refcount가 0이면 이미 free된 프레임 (double free), 예약 프레임은 해제 불가
+static bool pmm_zone_free_frame(uint32_t page_idx) {
+    page_t* page = &page_array[page_idx];
+    if (page_ref_count(page) <= 0 || page_test_flag(page, PAGE_FLAG_RESERVED)) {
+        return false;
+    }
+
+    if (!page_ref_dec_and_test(page)) {
+        return true;  // 다른 참조가 남아 있음
+    }
+    page->flags = 0;
+
+    pmm_zone_t* zone = pmm_zone_of(page_idx);
+    pmm_pcp_t* pcp = pmm_this_cpu_cache(zone);
+
+    if (pcp->count >= PMM_PCP_HIGH) {
+        pmm_pcp_drain(zone, pcp, PMM_PCP_LOW);
+    }
+    pcp->frames[pcp->count++] = page_idx;
+    return true;
+}
+
+// 버디/CPU 캐시/zone 카운터는 idle 태스크의 zero 풀 채우기, 선점된 다른 태스크, IRQ가
+// 같이 건드리므로 공개 할당/해제 함수는 모두 irq_save 안에서 아래 내부 함수를 부름
+// (내부 함수는 호출자가 irq_save 상태라고 가정)
+
+// 프레임 하나 할당 (top zone부터 낮은 zone으로 fallback), 전역 페이지 인덱스 반환
+static bool pmm_alloc_one(uint32_t top, uint32_t* out_page_idx) {
+    for (uint32_t z = top + 1; z-- > 0;) {
+        if (pmm_zone_alloc_frame(&pmm_zones[z], out_page_idx)) {
+            pmm_pages_init_allocated(*out_page_idx, 1);
+            return true;
         }
     }
+    return false;
+}
 
-    return NULL;
+// 프레임 하나 할당 (flags의 zone부터 낮은 zone으로 fallback)
+// HIGH 프레임은 커널 가상 주소가 없으므로 void* API는 NORMAL까지만 씀
+void* pmm_alloc_page_flags(uint32_t flags) {
+    if (!page_array) {
+        return NULL;
+    }
+
+    uint32_t page_idx;
+    uint32_t irq = irq_save();
+    bool ok = pmm_alloc_one(pmm_zone_top(flags & ~PMM_ZONE_HIGH), &page_idx);
+    irq_restore(irq);
+
+    return ok ? pmm_idx_to_ptr(page_idx) : NULL;
+}
+
+void* pmm_alloc_page(void) {
+    return pmm_alloc_page_flags(PMM_ZONE_NORMAL);
 }
 
 bool pmm_free_page(void* page) {
-    if (!bitmap || !page) {
+    if (!page_array || !page) {
         return false;
     }
 
-    uint32_t page_addr = (uint32_t)(uintptr_t)page;
-    
-    if (page_addr < memory_start || page_addr >= memory_end) {
+    uint32_t page_idx;
+    if (!pmm_phys_to_idx(vmm_virt_to_phys(page), &page_idx)) {
         return false;
     }
 
-    if ((page_addr & 0xFFF) != 0) {
+    uint32_t irq = irq_save();
+    bool ok = pmm_zone_free_frame(page_idx);
+    irq_restore(irq);
+    return ok;
+}
+
+// 2^order 블록 하나 (캐시를 비운 뒤 한 번 더 시도)
+static bool pmm_alloc_block(uint32_t order, uint32_t top, uint32_t* out_page_idx) {
+    for (uint32_t attempt = 0; attempt < 2; attempt++) {
+        for (uint32_t z = top + 1; z-- > 0;) {
+            if (pmm_take_block(&pmm_zones[z], order, out_page_idx)) {
+                pmm_pages_init_allocated(*out_page_idx, 1u << order);
+                return true;
+            }
+        }
+
+        if (!pmm_drain_all_caches()) {
+            break;
+        }
+    }
+
+    return false;
+}
+
+// 2^order개의 연속 페이지 할당 (블록 크기로 정렬됨)
+void* pmm_alloc_order_flags(uint32_t order, uint32_t flags) {
+    if (!page_array || order > PMM_MAX_ORDER) {
+        return NULL;
+    }
+
+    uint32_t start_idx;
+    uint32_t irq = irq_save();
+    bool ok = pmm_alloc_block(order, pmm_zone_top(flags & ~PMM_ZONE_HIGH), &start_idx);
+    irq_restore(irq);
+
+    return ok ? pmm_idx_to_ptr(start_idx) : NULL;
+}
+
+void* pmm_alloc_order(uint32_t order) {
+    return pmm_alloc_order_flags(order, PMM_ZONE_NORMAL);
+}
+
+// pmm_alloc_order로 받은 블록 해제
+bool pmm_free_order(void* page, uint32_t order) {
+    if (!page || order > PMM_MAX_ORDER) {
         return false;
     }
 
-    uint32_t page_offset = (uint32_t)(page_addr - memory_start);
-    uint32_t page_idx = page_offset >> 12;
-    
-    if (page_idx >= total_pages) {
+    uint32_t page_idx;
+    if (!pmm_phys_to_idx(vmm_virt_to_phys(page), &page_idx)) {
         return false;
     }
 
-    if (!bitmap_get(page_idx)) {
+    // 물리 주소 기준 order 크기로 정렬되지 않은 블록
+    if (pmm_zone_buddy_idx(pmm_zone_of(page_idx), page_idx) & ((1u << order) - 1)) {
         return false;
     }
 
-    bitmap_clear(page_idx);
-    free_pages++;
+    return pmm_free_pages_range(page, 1u << order);
+}
+
+// count를 담는 블록을 zone 버디에서 찾음 (4MB 초과는 최대 order 블록을 이어 붙임)
+static bool pmm_find_pages(pmm_zone_t* zone, uint32_t count,
+                           uint32_t* out_page_idx, uint32_t* out_reserved) {
+    if (zone->free_pages < count) {
+        return false;
+    }
+
+    uint32_t order = 0;
+    while (order <= PMM_MAX_ORDER && (1u << order) < count) {
+        order++;
+    }
+
+    uint32_t buddy_idx;
+    if (order <= PMM_MAX_ORDER) {
+        *out_reserved = 1u << order;
+        if (!buddy_alloc_block(zone->orders, order, 0, &buddy_idx)) {
+            return false;
+        }
+    } else {
+        *out_reserved = ((count + (1u << PMM_MAX_ORDER) - 1) >> PMM_MAX_ORDER) << PMM_MAX_ORDER;
+        if (!buddy_alloc_run(zone->orders, count, &buddy_idx)) {
+            return false;
+        }
+    }
+
+    *out_page_idx = pmm_zone_page_idx(zone, buddy_idx);
     return true;
 }
 
+// count를 담는 최소 order 블록을 받은 뒤 남는 꼬리 페이지는 버디에 되돌림
+static bool pmm_alloc_run(uint32_t count, uint32_t top, uint32_t* out_page_idx) {
+    for (uint32_t attempt = 0; attempt < 2; attempt++) {
+        for (uint32_t z = top + 1; z-- > 0;) {
+            pmm_zone_t* zone = &pmm_zones[z];
+            uint32_t start_idx;
+            uint32_t reserved;
+            if (!pmm_find_pages(zone, count, &start_idx, &reserved)) {
+                continue;
+            }
+
+            pmm_pages_init_allocated(start_idx, count);
+            zone->free_pages -= count;
+
+            // 요청보다 큰 블록의 남는 부분 반환 (free_pages는 이미 제외하지 않았음)
+            uint32_t buddy_idx = pmm_zone_buddy_idx(zone, start_idx);
+            buddy_free_range(zone->orders, buddy_idx + count, buddy_idx + reserved);
+
+            *out_page_idx = start_idx;
+            return true;
+        }
+
+        if (!pmm_drain_all_caches()) {
+            break;
+        }
+    }
+
+    return false;
+}
+
 // 연속된 count개의 페이지 할당
 // 원자적(atomic) 동작: 모두 할당 가능하면 할당, 아니면 NULL 반환
 // 부분 할당 없음 - 메모리 누수 방지
-void* pmm_alloc_pages(uint32_t count) {
-    if (!bitmap || free_pages < count || count == 0) {
+void* pmm_alloc_pages_flags(uint32_t count, uint32_t flags) {
+    if (!page_array || count == 0) {
         return NULL;
     }
 
-    // 1단계: 연속된 free 페이지 찾기 (할당하지 않음)
-    uint32_t consecutive = 0;
-    uint32_t start_idx = 0;
-    bool found = false;
-    
-    for (uint32_t i = 0; i < total_pages; i++) {
-        if (!bitmap_get(i)) {
-            if (consecutive == 0) {
-                start_idx = i;
-            }
-            consecutive++;
-            
-            if (consecutive == count) {
-                found = true;
-                break;
-            }
-        } else {
-            consecutive = 0;
-        }
+    uint32_t start_idx;
+    uint32_t irq = irq_save();
+    bool ok = pmm_alloc_run(count, pmm_zone_top(flags & ~PMM_ZONE_HIGH), &start_idx);
+    irq_restore(irq);
+
+    return ok ? pmm_idx_to_ptr(start_idx) : NULL;
+}
+
+void* pmm_alloc_pages(uint32_t count) {
+    return pmm_alloc_pages_flags(count, PMM_ZONE_NORMAL);
+}
+
+// 할당 상태인 [start_idx, start_idx + count)를 버디에 반환
+static bool pmm_free_run(uint32_t start_idx, uint32_t count) {
+    // 할당은 zone 경계를 넘지 않음
+    pmm_zone_t* zone = pmm_zone_of(start_idx);
+    if (count > zone->end - start_idx) {
+        return false;
     }
 
-    if (!found) {
-        return NULL;
+    // 모든 페이지가 이 호출자만 참조하는 할당 상태인지 확인
+    // (공유 프레임은 pmm_free_page/page_put으로 참조를 하나씩 놓아야 함)
+    for (uint32_t i = 0; i < count; i++) {
+        const page_t* desc = &page_array[start_idx + i];
+        if (page_ref_count(desc) != 1 || page_test_flag(desc, PAGE_FLAG_RESERVED)) {
+            return false;  // 이미 free되었거나 공유/예약된 페이지 포함
+        }
     }
 
-    // 2단계: 연속된 페이지 발견 후 모두 할당 (원자적)
-    for (uint32_t j = 0; j < count; j++) {
-        bitmap_set(start_idx + j);
+    for (uint32_t i = 0; i < count; i++) {
+        page_array[start_idx + i].flags = 0;
+        page_array[start_idx + i].refcount = 0;
     }
-    free_pages -= count;
-    
-    return (void*)(uintptr_t)(memory_start + start_idx * PAGE_SIZE);
+
+    // 모두 해제 후 버디에 병합
+    pmm_release_pages(zone, start_idx, count);
+
+    return true;
 }
 
 // 연속된 count개의 페이지 해제
 bool pmm_free_pages_range(void* page, uint32_t count) {
-    if (!bitmap || !page || count == 0) {
+    if (!page_array || !page || count == 0) {
         return false;
     }
 
-    uint32_t page_addr = (uint32_t)(uintptr_t)page;
-    
-    if (page_addr < memory_start || page_addr >= memory_end) {
+    uint32_t start_idx;
+    if (!pmm_phys_to_idx(vmm_virt_to_phys(page), &start_idx)) {
         return false;
     }
 
-    if ((page_addr & 0xFFF) != 0) {
+    uint32_t irq = irq_save();
+    bool ok = pmm_free_run(start_idx, count);
+    irq_restore(irq);
+    return ok;
+}
+
+// 프레임 하나를 물리 주소로 할당 (실패 시 0)
+// 4GB 위 -> HIGH zone -> 아래 zone 순서로 써서 32비트 주소 프레임과 직접 매핑되는 저위 메모리를 아껴 둠
+// HIGH zone은 512MB부터라 낮은 주소 우선 검색만으로는 4GB 아래가 먼저 나가므로 4GB 위를 따로 찾음
+phys_addr_t pmm_alloc_frame(void) {
+    if (!page_array) {
+        return 0;
+    }
+
+    uint32_t page_idx;
+    uint32_t irq = irq_save();
+    bool ok = false;
+    if (memory_end > PMM_LOW_LIMIT) {
+        ok = pmm_take_block_above(&pmm_zones[PMM_ZONE_ID_HIGH], 0, pmm_phys_to_boundary(PMM_LOW_LIMIT), &page_idx);
+        if (ok) {
+            pmm_pages_init_allocated(page_idx, 1);
+        }
+    }
+    if (!ok) {
+        ok = pmm_alloc_one(PMM_ZONE_ID_HIGH, &page_idx);
+    }
+    irq_restore(irq);
+
+    return ok ? pmm_idx_to_phys(page_idx) : 0;
+}
+
+bool pmm_free_frame(phys_addr_t frame) {
+    if (!page_array) {
         return false;
     }
 
-    uint32_t page_offset = (uint32_t)(page_addr - memory_start);
-    uint32_t start_idx = page_offset >> 12;
-    
-    if (start_idx + count > total_pages) {
+    uint32_t page_idx;
+    if (!pmm_phys_to_idx(frame, &page_idx)) {
         return false;
     }
 
-    // 모든 페이지가 할당된 상태인지 확인
-    for (uint32_t i = 0; i < count; i++) {
-        if (!bitmap_get(start_idx + i)) {
-            return false;  // 이미 free된 페이지 포함
+    uint32_t irq = irq_save();
+    bool ok = pmm_zone_free_frame(page_idx);
+    irq_restore(irq);
+    return ok;
+}
+
+// 0으로 채워진 프레임 하나 (풀에서 O(1), 비어 있으면 그 자리에서 지움)
+void* pmm_alloc_zeroed_page(void) {
+    if (!page_array) {
+        return NULL;
+    }
+
+    uint32_t irq = irq_save();
+    if (zero_pool.count > 0) {
+        uint32_t page_idx = zero_pool.frames[--zero_pool.count];
+        zero_pool.hits++;
+        irq_restore(irq);
+        pmm_pages_init_allocated(page_idx, 1);
+        return pmm_idx_to_ptr(page_idx);
+    }
+    zero_pool.misses++;
+    irq_restore(irq);
+
+    void* page = pmm_alloc_page();
+    if (page) {
+        pmm_zero_frame(page);
+    }
+    return page;
+}
+
+// 풀을 최대 budget장까지 채움, 채운 장 수 반환 (가득 찼거나 메모리가 없으면 0)
+// 인터럽트는 풀 검사+프레임 할당, 풀에 넣기 두 구간에서만 막고 지우는 동안에는 켜 둠
+// 그 사이 선점되어도 프레임은 아직 이 호출만의 것이라 다른 PMM 사용자와 겹치지 않음
+uint32_t pmm_zero_pool_refill(uint32_t budget) {
+    uint32_t added = 0;
+
+    while (added < budget && page_array) {
+        uint32_t irq = irq_save();
+        bool full = zero_pool.count >= PMM_ZERO_POOL_SIZE;
+        void* page = full ? NULL : pmm_alloc_page();
+        irq_restore(irq);
+
+        if (!page) {
+            break;
+        }
+
+        pmm_zero_frame(page);
+
+        irq = irq_save();
+        if (zero_pool.count < PMM_ZERO_POOL_SIZE) {
+            uint32_t page_idx = (uint32_t)((vmm_virt_to_phys(page) - memory_start) >> 12);
+            page_array[page_idx].refcount = 0;  // 풀 안의 프레임은 free
+            zero_pool.frames[zero_pool.count++] = page_idx;
+            page = NULL;
         }
+        irq_restore(irq);
+
+        // 지우는 사이 다른 쪽이 풀을 채웠으면 되돌림
+        if (page) {
+            pmm_free_page(page);
+            break;
+        }
+        added++;
     }
 
-    // 모두 해제
-    for (uint32_t i = 0; i < count; i++) {
-        bitmap_clear(start_idx + i);
+    return added;
+}
+
+uint32_t pmm_zero_pool_count(void) {
+    return zero_pool.count;
+}
+
+uint32_t pmm_zero_pool_hits(void) {
+    return zero_pool.hits;
+}
+
+uint32_t pmm_zero_pool_misses(void) {
+    return zero_pool.misses;
+}
+
+// 프레임 디스크립터 조회 (PFN = 물리 주소 >> 12)
+page_t* pfn_to_page(uint32_t pfn) {
+    uint32_t base_pfn = (uint32_t)(memory_start >> 12);
+    if (!page_array || pfn < base_pfn || pfn - base_pfn >= total_pages) {
+        return NULL;
     }
-    free_pages += count;
-    
-    return true;
+    return &page_array[pfn - base_pfn];
+}
+
+uint32_t page_to_pfn(const page_t* page) {
+    if (!page_array || page < page_array || page >= page_array + total_pages) {
+        return 0;
+    }
+    return (uint32_t)(memory_start >> 12) + (uint32_t)(page - page_array);
+}
+
+page_t* phys_to_page(phys_addr_t phys) {
+    return pfn_to_page((uint32_t)(phys >> 12));
+}
+
+phys_addr_t page_to_phys(const page_t* page) {
+    return (phys_addr_t)page_to_pfn(page) << 12;
+}
+
+// 공유 프레임의 참조 하나 해제 (마지막 참조면 PMM으로 반환)
+void page_put(page_t* page) {
+    uint32_t pfn = page_to_pfn(page);
+    if (pfn) {
+        pmm_free_frame((phys_addr_t)pfn << 12);
+    }
+}
+
+// 관리 중인 물리 메모리의 끝 주소
+phys_addr_t pmm_memory_end(void) {
+    return memory_end;
+}
+
+// 커널이 직접 매핑해야 하는 물리 메모리 끝 (DMA + NORMAL zone)
+phys_addr_t pmm_direct_map_end(void) {
+    if (!page_array) {
+        return 0;
+    }
+    return pmm_idx_to_phys(pmm_zones[PMM_ZONE_ID_NORMAL].end);
+}
+
+// pmm_init에 걸린 시간 (마이크로초, TSC 기준)
+uint32_t pmm_init_time_us(void) {
+    return init_time_us;
 }
 
 uint32_t pmm_total_pages(void) {
     return total_pages;
 }
 
+// zone의 free 페이지 (버디 + CPU 캐시)
+uint32_t pmm_zone_free_pages(pmm_zone_id_t zone_id) {
+    if (zone_id >= PMM_ZONE_COUNT) {
+        return 0;
+    }
+
+    const pmm_zone_t* zone = &pmm_zones[zone_id];
+    uint32_t free = zone->free_pages;
+    for (uint32_t cpu = 0; cpu < PMM_MAX_CPUS; cpu++) {
+        free += zone->pcp[cpu].count;
+    }
+    return free;
+}
+
+uint32_t pmm_zone_total_pages(pmm_zone_id_t zone_id) {
+    if (zone_id >= PMM_ZONE_COUNT) {
+        return 0;
+    }
+    return pmm_zones[zone_id].end - pmm_zones[zone_id].start;
+}
+
+// zone 버디에 있는 2^order 페이지 free 블록 수 (CPU 캐시 제외, 단편화 측정용)
+uint32_t pmm_zone_free_blocks(pmm_zone_id_t zone_id, uint32_t order) {
+    if (zone_id >= PMM_ZONE_COUNT || order > PMM_MAX_ORDER) {
+        return 0;
+    }
+    return pmm_zones[zone_id].orders[order].free_count;
+}
+
+// 전체 zone의 free 페이지 + CPU 캐시/zero 풀에 보관 중인 프레임
 uint32_t pmm_get_free_pages(void) {
-    return free_pages;
+    uint32_t free = zero_pool.count;
+    for (uint32_t z = 0; z < PMM_ZONE_COUNT; z++) {
+        free += pmm_zone_free_pages((pmm_zone_id_t)z);
+    }
+    return free;
 }
@@ -0,0 +1,501 @@
+#include "mem/slab.h"
+#include "mem/pmm.h"
+#include "mem/page.h"
+#include "arch/x86/irqflags.h"
+#include "drivers/console/console.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// 이 크기 이상인 객체는 slab 헤더를 slab 밖(slab_cache)에 둠
+// 4KB 스택처럼 큰 객체에 헤더를 붙이면 페이지 하나를 통째로 낭비하게 됨
+#define SLAB_OFFSLAB_THRESHOLD  (PAGE_SIZE / 8u)
+
+// 캐시마다 남겨둘 빈 slab 수 (넘치면 PMM에 반환)
+#define SLAB_MAX_EMPTY          1u
+
+typedef struct slab {
+    struct slab* next;
+    struct slab* prev;
+    kmem_cache_t* cache;
+    void* pages;            // slab 프레임 시작 (2^order 페이지)
+    uint8_t* mem;           // 첫 객체 (헤더 + colour 뒤)
+    void* free;             // 빈 객체 리스트
+    uint32_t inuse;
+} slab_t;
+
+struct kmem_cache {
+    char name[SLAB_NAME_LEN];
+    uint32_t object_size;   // 요청 크기
+    uint32_t size;          // 객체 간격 (정렬 + free 포인터 포함)
+    uint32_t align;
+    uint32_t free_offset;   // 빈 객체 안에서 다음 포인터가 놓이는 위치
+    uint32_t order;
+    uint32_t objs_per_slab;
+    uint32_t header_size;   // on-slab 헤더 크기 (off-slab이면 0)
+    uint32_t colour_count;  // 가능한 colour 개수
+    uint32_t colour_step;   // colour 하나의 크기 (캐시 라인)
+    uint32_t colour_next;
+    bool off_slab;
+    kmem_ctor_t ctor;
+
+    slab_t* slabs_full;
+    slab_t* slabs_partial;
+    slab_t* slabs_empty;
+    uint32_t empty_slabs;
+
+    uint32_t active_objs;
+    uint32_t total_objs;
+    uint32_t slab_count;
+
+    kmem_cache_t* next;     // 전체 캐시 리스트
+};
+
+// 부트스트랩 캐시: kmem_cache_t 자체와 off-slab 헤더
+static kmem_cache_t cache_cache;
+static kmem_cache_t slab_cache;
+static kmem_cache_t* cache_list = NULL;
+static bool slab_initialized = false;
+
+static void console_putu32(uint32_t value) {
+    char buf[11];
+    int idx = 0;
+    if (value == 0) {
+        console_putc('0');
+        return;
+    }
+    while (value > 0 && idx < 10) {
+        buf[idx++] = (char)('0' + (value % 10));
+        value /= 10;
+    }
+    while (idx--) console_putc(buf[idx]);
+}
+
+static inline uint32_t slab_round_up(uint32_t value, uint32_t align) {
+    return (value + align - 1) & ~(align - 1);
+}
+
+static inline void* slab_get_free_ptr(const kmem_cache_t* cache, void* obj) {
+    return *(void**)((uint8_t*)obj + cache->free_offset);
+}
+
+static inline void slab_set_free_ptr(const kmem_cache_t* cache, void* obj, void* next) {
+    *(void**)((uint8_t*)obj + cache->free_offset) = next;
+}
+
+// slab 상태(사용 중 객체 수)에 맞는 리스트
+static slab_t** slab_list_for(kmem_cache_t* cache, uint32_t inuse) {
+    if (inuse == 0) {
+        return &cache->slabs_empty;
+    }
+    if (inuse == cache->objs_per_slab) {
+        return &cache->slabs_full;
+    }
+    return &cache->slabs_partial;
+}
+
+static void slab_list_push(slab_t** head, slab_t* slab) {
+    slab->prev = NULL;
+    slab->next = *head;
+    if (*head) {
+        (*head)->prev = slab;
+    }
+    *head = slab;
+}
+
+static void slab_list_remove(slab_t** head, slab_t* slab) {
+    if (slab->prev) {
+        slab->prev->next = slab->next;
+    } else {
+        *head = slab->next;
+    }
+    if (slab->next) {
+        slab->next->prev = slab->prev;
+    }
+    slab->next = NULL;
+    slab->prev = NULL;
+}
+
+static void slab_copy_name(char* dst, const char* src) {
+    uint32_t i = 0;
+    if (src) {
+        while (src[i] && i < SLAB_NAME_LEN - 1) {
+            dst[i] = src[i];
+            i++;
+        }
+    }
+    dst[i] = '\0';
+}
+
+// 객체 간격, slab order, colour 범위 계산
+static bool slab_cache_setup(kmem_cache_t* cache, const char* name, size_t size,
+                             size_t align, kmem_ctor_t ctor, bool allow_off_slab) {
+    if (size == 0 || size > (PAGE_SIZE << SLAB_MAX_ORDER)) {
+        return false;
+    }
+    if (align == 0) {
+        align = sizeof(void*);
+    }
+    if ((align & (align - 1)) != 0 || align > PAGE_SIZE) {
+        return false;
+    }
+    if (align < sizeof(void*)) {
+        align = sizeof(void*);
+    }
+
+    slab_copy_name(cache->name, name);
+    cache->object_size = (uint32_t)size;
+    cache->align = (uint32_t)align;
+    cache->ctor = ctor;
+
+    // 생성자가 있으면 free 포인터가 생성된 상태를 덮어쓰지 않도록 객체 뒤에 둠
+    uint32_t obj_size = (uint32_t)size;
+    if (ctor) {
+        cache->free_offset = slab_round_up(obj_size, sizeof(void*));
+        obj_size = cache->free_offset + sizeof(void*);
+    } else {
+        cache->free_offset = 0;
+        if (obj_size < sizeof(void*)) {
+            obj_size = sizeof(void*);
+        }
+    }
+    cache->size = slab_round_up(obj_size, cache->align);
+
+    cache->off_slab = allow_off_slab && cache->size >= SLAB_OFFSLAB_THRESHOLD;
+    cache->header_size = cache->off_slab ? 0 : slab_round_up(sizeof(slab_t), cache->align);
+
+    // 낭비가 slab 크기의 1/8 이하가 되는 가장 작은 order
+    uint32_t objs = 0;
+    uint32_t left = 0;
+    uint32_t order;
+    for (order = 0; order <= SLAB_MAX_ORDER; order++) {
+        uint32_t bytes = PAGE_SIZE << order;
+        if (bytes < cache->header_size + cache->size) {
+            continue;
+        }
+        objs = (bytes - cache->header_size) / cache->size;
+        left = bytes - cache->header_size - objs * cache->size;
+        if (left * 8 <= bytes) {
+            break;
+        }
+    }
+    if (objs == 0) {
+        return false;
+    }
+    if (order > SLAB_MAX_ORDER) {
+        order = SLAB_MAX_ORDER;
+    }
+
+    cache->order = order;
+    cache->objs_per_slab = objs;
+    cache->colour_step = cache->align > SLAB_CACHE_LINE ? cache->align : SLAB_CACHE_LINE;
+    cache->colour_count = left / cache->colour_step + 1;
+    cache->colour_next = 0;
+
+    cache->slabs_full = NULL;
+    cache->slabs_partial = NULL;
+    cache->slabs_empty = NULL;
+    cache->empty_slabs = 0;
+    cache->active_objs = 0;
+    cache->total_objs = 0;
+    cache->slab_count = 0;
+    cache->next = NULL;
+    return true;
+}
+
+static void* slab_alloc_obj(kmem_cache_t* cache);
+static bool slab_free_obj(kmem_cache_t* cache, void* obj);
+
+// 새 slab을 만들어 빈 리스트에 추가
+static slab_t* slab_grow(kmem_cache_t* cache) {
+    uint8_t* pages = (uint8_t*)pmm_alloc_order(cache->order);
+    if (!pages) {
+        return NULL;
+    }
+
+    slab_t* slab;
+    if (cache->off_slab) {
+        slab = (slab_t*)slab_alloc_obj(&slab_cache);
+        if (!slab) {
+            pmm_free_order(pages, cache->order);
+            return NULL;
+        }
+    } else {
+        slab = (slab_t*)pages;
+    }
+
+    uint32_t colour = cache->colour_next * cache->colour_step;
+    cache->colour_next++;
+    if (cache->colour_next >= cache->colour_count) {
+        cache->colour_next = 0;
+    }
+
+    slab->cache = cache;
+    slab->pages = pages;
+    slab->mem = pages + cache->header_size + colour;
+    slab->inuse = 0;
+
+    // 낮은 주소부터 나가도록 뒤에서부터 free list 구성
+    void* free = NULL;
+    for (uint32_t i = cache->objs_per_slab; i-- > 0;) {
+        void* obj = slab->mem + i * cache->size;
+        if (cache->ctor) {
+            cache->ctor(obj);
+        }
+        slab_set_free_ptr(cache, obj, free);
+        free = obj;
+    }
+    slab->free = free;
+
+    // 객체 주소 -> slab 역참조
+    for (uint32_t i = 0; i < (1u << cache->order); i++) {
+        page_t* page = virt_to_page(pages + i * PAGE_SIZE);
+        if (page) {
+            page_set_flag(page, PAGE_FLAG_SLAB);
+            page->private = (uintptr_t)slab;
+        }
+    }
+
+    slab_list_push(&cache->slabs_empty, slab);
+    cache->empty_slabs++;
+    cache->total_objs += cache->objs_per_slab;
+    cache->slab_count++;
+    return slab;
+}
+
+// 빈 slab을 PMM에 반환
+static void slab_destroy(kmem_cache_t* cache, slab_t* slab) {
+    slab_list_remove(&cache->slabs_empty, slab);
+    cache->empty_slabs--;
+    cache->total_objs -= cache->objs_per_slab;
+    cache->slab_count--;
+
+    uint8_t* pages = (uint8_t*)slab->pages;
+    for (uint32_t i = 0; i < (1u << cache->order); i++) {
+        page_t* page = virt_to_page(pages + i * PAGE_SIZE);
+        if (page) {
+            page->private = 0;
+            page_clear_flag(page, PAGE_FLAG_SLAB);
+        }
+    }
+
+    if (cache->off_slab) {
+        slab_free_obj(&slab_cache, slab);
+    }
+    pmm_free_order(pages, cache->order);
+}
+
+static void* slab_alloc_obj(kmem_cache_t* cache) {
+    slab_t* slab = cache->slabs_partial;
+    if (!slab) {
+        slab = cache->slabs_empty;
+    }
+    if (!slab) {
+        slab = slab_grow(cache);
+        if (!slab) {
+            return NULL;
+        }
+    }
+
+    if (slab->inuse == 0) {
+        cache->empty_slabs--;
+    }
+    slab_list_remove(slab_list_for(cache, slab->inuse), slab);
+
+    void* obj = slab->free;
+    slab->free = slab_get_free_ptr(cache, obj);
+    slab->inuse++;
+    cache->active_objs++;
+
+    slab_list_push(slab_list_for(cache, slab->inuse), slab);
+    return obj;
+}
+
+static bool slab_free_obj(kmem_cache_t* cache, void* obj) {
+    page_t* page = virt_to_page(obj);
+    if (!page || !page_test_flag(page, PAGE_FLAG_SLAB)) {
+        console_puts("[SLAB] Free of non-slab object\n");
+        return false;
+    }
+
+    slab_t* slab = (slab_t*)page->private;
+    if (!slab || slab->cache != cache) {
+        console_puts("[SLAB] Object freed to wrong cache\n");
+        return false;
+    }
+
+    uint8_t* p = (uint8_t*)obj;
+    uint32_t offset = (uint32_t)(p - slab->mem);
+    if (p < slab->mem || offset >= cache->objs_per_slab * cache->size ||
+        offset % cache->size != 0 || slab->inuse == 0) {
+        console_puts("[SLAB] Invalid object pointer\n");
+        return false;
+    }
+
+    slab_list_remove(slab_list_for(cache, slab->inuse), slab);
+
+    slab_set_free_ptr(cache, obj, slab->free);
+    slab->free = obj;
+    slab->inuse--;
+    cache->active_objs--;
+
+    slab_list_push(slab_list_for(cache, slab->inuse), slab);
+    if (slab->inuse == 0) {
+        cache->empty_slabs++;
+        if (cache->empty_slabs > SLAB_MAX_EMPTY) {
+            slab_destroy(cache, slab);
+        }
+    }
+    return true;
+}
+
+void kmem_cache_init(void) {
+    cache_list = NULL;
+
+    slab_cache_setup(&cache_cache, "kmem_cache", sizeof(kmem_cache_t), 0, NULL, false);
+    slab_cache_setup(&slab_cache, "slab", sizeof(slab_t), 0, NULL, false);
+
+    cache_cache.next = &slab_cache;
+    cache_list = &cache_cache;
+    slab_initialized = true;
+
+    console_puts("[SLAB] Initialized (cache line ");
+    console_putu32(SLAB_CACHE_LINE);
+    console_puts(" bytes)\n");
+}
+
+kmem_cache_t* kmem_cache_create(const char* name, size_t size, size_t align, kmem_ctor_t ctor) {
+    if (!slab_initialized) {
+        console_puts("[SLAB] kmem_cache_create before kmem_cache_init\n");
+        return NULL;
+    }
+
+    uint32_t irq = irq_save();
+    kmem_cache_t* cache = (kmem_cache_t*)slab_alloc_obj(&cache_cache);
+    irq_restore(irq);
+    if (!cache) {
+        console_puts("[SLAB] Failed to allocate cache descriptor\n");
+        return NULL;
+    }
+
+    if (!slab_cache_setup(cache, name, size, align, ctor, true)) {
+        console_puts("[SLAB] Invalid cache parameters for '");
+        console_puts(name ? name : "?");
+        console_puts("'\n");
+        irq = irq_save();
+        slab_free_obj(&cache_cache, cache);
+        irq_restore(irq);
+        return NULL;
+    }
+
+    irq = irq_save();
+    cache->next = cache_list;
+    cache_list = cache;
+    irq_restore(irq);
+    return cache;
+}
+
+bool kmem_cache_destroy(kmem_cache_t* cache) {
+    if (!cache || cache == &cache_cache || cache == &slab_cache) {
+        return false;
+    }
+
+    uint32_t irq = irq_save();
+    if (cache->active_objs != 0) {
+        irq_restore(irq);
+        console_puts("[SLAB] Destroying cache '");
+        console_puts(cache->name);
+        console_puts("' with live objects\n");
+        return false;
+    }
+
+    while (cache->slabs_empty) {
+        slab_destroy(cache, cache->slabs_empty);
+    }
+
+    kmem_cache_t** link = &cache_list;
+    while (*link && *link != cache) {
+        link = &(*link)->next;
+    }
+    if (*link) {
+        *link = cache->next;
+    }
+
+    slab_free_obj(&cache_cache, cache);
+    irq_restore(irq);
+    return true;
+}
+
+void* kmem_cache_alloc(kmem_cache_t* cache) {
+    if (!cache) {
+        return NULL;
+    }
+
+    uint32_t irq = irq_save();
+    void* obj = slab_alloc_obj(cache);
+    irq_restore(irq);
+    return obj;
+}
+
+bool kmem_cache_free(kmem_cache_t* cache, void* obj) {
+    if (!cache || !obj) {
+        return false;
+    }
+
+    uint32_t irq = irq_save();
+    bool ok = slab_free_obj(cache, obj);
+    irq_restore(irq);
+    return ok;
+}
+
+uint32_t kmem_cache_shrink(kmem_cache_t* cache) {
+    if (!cache) {
+        return 0;
+    }
+
+    uint32_t irq = irq_save();
+    uint32_t freed = 0;
+    while (cache->slabs_empty) {
+        slab_destroy(cache, cache->slabs_empty);
+        freed += 1u << cache->order;
+    }
+    irq_restore(irq);
+    return freed;
+}
+
+uint32_t kmem_cache_object_size(const kmem_cache_t* cache) {
+    return cache ? cache->object_size : 0;
+}
+
+uint32_t kmem_cache_active_objects(const kmem_cache_t* cache) {
+    return cache ? cache->active_objs : 0;
+}
+
+uint32_t kmem_cache_total_objects(const kmem_cache_t* cache) {
+    return cache ? cache->total_objs : 0;
+}
+
+uint32_t kmem_cache_slab_count(const kmem_cache_t* cache) {
+    return cache ? cache->slab_count : 0;
+}
+
+void kmem_cache_print_stats(void) {
+    for (kmem_cache_t* cache = cache_list; cache; cache = cache->next) {
+        console_puts("[SLAB] ");
+        console_puts(cache->name);
+        console_puts(": ");
+        console_putu32(cache->active_objs);
+        console_puts("/");
+        console_putu32(cache->total_objs);
+        console_puts(" objs, ");
+        console_putu32(cache->slab_count);
+        console_puts(" slabs (");
+        console_putu32(cache->size);
+        console_puts(" B/obj, order ");
+        console_putu32(cache->order);
+        console_puts(cache->off_slab ? ", off-slab" : "");
+        console_puts(", ");
+        console_putu32(cache->colour_count);
+        console_puts(" colours)\n");
+    }
+}
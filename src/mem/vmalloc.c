@@ -0,0 +1,281 @@
+#include "mem/vmalloc.h"
+#include "mem/vmm.h"
+#include "mem/pmm.h"
+#include "mem/page.h"
+#include "mem/slab.h"
+#include "arch/x86/irqflags.h"
+#include "drivers/console/console.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// 가상 영역 할당자
+// vmalloc 영역 전체를 vm_area_t 구간들로 나누어 주소 순 이중 연결 리스트로 유지하고,
+// free 구간은 페이지 수의 log2 클래스별 리스트 + 비트맵에 둠
+// -> 구간 찾기는 비트맵 한 번, 해제 시 병합은 주소 이웃만 보면 되므로 O(1)
+//
+// vfree에서 주소 -> 구간은 첫 프레임의 page_t->private로 찾음
+
+#define VM_CLASS_COUNT 32
+
+typedef struct vm_area {
+    uintptr_t addr;             // 시작 가상 주소
+    uint32_t pages;             // 구간 크기 (가드 페이지 포함)
+    uint32_t mapped;            // 매핑된 페이지 수 (사용 중일 때)
+    bool is_free;
+    struct vm_area* prev_addr;  // 주소 순 이웃
+    struct vm_area* next_addr;
+    struct vm_area* prev_free;  // 같은 크기 클래스 free 리스트
+    struct vm_area* next_free;
+} vm_area_t;
+
+static kmem_cache_t* vm_area_cache = NULL;
+static vm_area_t* free_classes[VM_CLASS_COUNT];
+static uint32_t free_class_map = 0;
+static uint32_t used_pages = 0;
+static uint32_t free_pages = 0;
+
+static inline uint32_t vm_class_of(uint32_t pages) {
+    return 31u - (uint32_t)__builtin_clz(pages);
+}
+
+static void vm_free_insert(vm_area_t* area) {
+    uint32_t cls = vm_class_of(area->pages);
+    area->is_free = true;
+    area->prev_free = NULL;
+    area->next_free = free_classes[cls];
+    if (free_classes[cls]) {
+        free_classes[cls]->prev_free = area;
+    }
+    free_classes[cls] = area;
+    free_class_map |= 1u << cls;
+    free_pages += area->pages;
+}
+
+static void vm_free_remove(vm_area_t* area) {
+    uint32_t cls = vm_class_of(area->pages);
+    if (area->prev_free) {
+        area->prev_free->next_free = area->next_free;
+    } else {
+        free_classes[cls] = area->next_free;
+        if (!free_classes[cls]) {
+            free_class_map &= ~(1u << cls);
+        }
+    }
+    if (area->next_free) {
+        area->next_free->prev_free = area->prev_free;
+    }
+    area->prev_free = NULL;
+    area->next_free = NULL;
+    area->is_free = false;
+    free_pages -= area->pages;
+}
+
+// pages 이상인 free 구간 찾기
+// 올림한 클래스에 있는 구간은 무엇이든 충분히 크므로 바로 꺼내고,
+// 그런 구간이 없을 때만 같은 클래스 리스트를 first-fit으로 훑음
+static vm_area_t* vm_find_free(uint32_t pages) {
+    uint32_t cls = vm_class_of(pages);
+    uint32_t fit_cls = (pages & (pages - 1)) ? cls + 1 : cls;
+
+    uint32_t map = fit_cls < 32 ? free_class_map & (~0u << fit_cls) : 0;
+    if (map) {
+        return free_classes[__builtin_ctz(map)];
+    }
+
+    for (vm_area_t* area = free_classes[cls]; area; area = area->next_free) {
+        if (area->pages >= pages) {
+            return area;
+        }
+    }
+    return NULL;
+}
+
+// 가상 구간 예약 (free 리스트에서 꺼내고 남는 뒤쪽은 다시 free로)
+static vm_area_t* vm_reserve(uint32_t pages) {
+    vm_area_t* area = vm_find_free(pages);
+    if (!area) {
+        return NULL;
+    }
+
+    vm_free_remove(area);
+
+    if (area->pages > pages) {
+        vm_area_t* rest = (vm_area_t*)kmem_cache_alloc(vm_area_cache);
+        if (rest) {
+            rest->addr = area->addr + pages * PAGE_SIZE;
+            rest->pages = area->pages - pages;
+            rest->mapped = 0;
+            rest->prev_addr = area;
+            rest->next_addr = area->next_addr;
+            if (area->next_addr) {
+                area->next_addr->prev_addr = rest;
+            }
+            area->next_addr = rest;
+            area->pages = pages;
+            vm_free_insert(rest);
+        }
+        // 디스크립터가 없으면 구간 전체를 그대로 씀 (해제 시 되돌아옴)
+    }
+
+    return area;
+}
+
+// 구간을 free로 되돌리고 주소 이웃 free 구간과 병합
+static void vm_release(vm_area_t* area) {
+    vm_area_t* prev = area->prev_addr;
+    if (prev && prev->is_free) {
+        vm_free_remove(prev);
+        prev->pages += area->pages;
+        prev->next_addr = area->next_addr;
+        if (area->next_addr) {
+            area->next_addr->prev_addr = prev;
+        }
+        kmem_cache_free(vm_area_cache, area);
+        area = prev;
+    }
+
+    vm_area_t* next = area->next_addr;
+    if (next && next->is_free) {
+        vm_free_remove(next);
+        area->pages += next->pages;
+        area->next_addr = next->next_addr;
+        if (next->next_addr) {
+            next->next_addr->prev_addr = area;
+        }
+        kmem_cache_free(vm_area_cache, next);
+    }
+
+    area->mapped = 0;
+    vm_free_insert(area);
+}
+
+// 구간 앞쪽 count 페이지 언매핑 후 프레임 반환
+static void vm_unmap_pages(uintptr_t start, uint32_t count) {
+    void* page_dir = vmm_get_kernel_page_dir();
+    for (uint32_t i = 0; i < count; i++) {
+        void* virt = (void*)(start + i * PAGE_SIZE);
+        phys_addr_t frame = vmm_lookup_phys(page_dir, virt);
+        if (vmm_unmap_page(page_dir, virt) && frame) {
+            page_t* page = phys_to_page(frame);
+            if (page) {
+                page->private = 0;
+            }
+            pmm_free_frame(frame);
+        }
+    }
+}
+
+void vmalloc_init(void) {
+    for (uint32_t i = 0; i < VM_CLASS_COUNT; i++) {
+        free_classes[i] = NULL;
+    }
+    free_class_map = 0;
+    used_pages = 0;
+    free_pages = 0;
+
+    vm_area_cache = kmem_cache_create("vm_area", sizeof(vm_area_t), 0, NULL);
+    vm_area_t* area = vm_area_cache ? (vm_area_t*)kmem_cache_alloc(vm_area_cache) : NULL;
+    if (!area) {
+        console_puts("[VMALLOC] Failed to create area descriptors\n");
+        return;
+    }
+
+    area->addr = VMM_VMALLOC_START;
+    area->pages = (VMM_VMALLOC_END - VMM_VMALLOC_START) / PAGE_SIZE;
+    area->mapped = 0;
+    area->prev_addr = NULL;
+    area->next_addr = NULL;
+    vm_free_insert(area);
+
+    console_puts("[VMALLOC] Area 0xF0000000-0xFE400000 ready\n");
+}
+
+void* vmalloc(size_t size) {
+    if (size == 0 || size > VMM_VMALLOC_END - VMM_VMALLOC_START) {
+        return NULL;
+    }
+
+    // 뒤에 가드 페이지 하나
+    uint32_t mapped = (uint32_t)((size + PAGE_SIZE - 1) / PAGE_SIZE);
+    uint32_t pages = mapped + 1;
+
+    uint32_t irq = irq_save();
+    vm_area_t* area = vm_reserve(pages);
+    irq_restore(irq);
+    if (!area) {
+        console_puts("[VMALLOC] Out of virtual space\n");
+        return NULL;
+    }
+
+    // 구간은 이제 이 호출만의 것이므로 매핑은 인터럽트를 켠 채로 진행
+    // (프레임 할당/해제는 PMM이 안에서 irq_save로 막음)
+    void* page_dir = vmm_get_kernel_page_dir();
+    for (uint32_t i = 0; i < mapped; i++) {
+        uintptr_t virt = area->addr + i * PAGE_SIZE;
+        phys_addr_t frame = pmm_alloc_frame();
+        if (!frame || !vmm_map_phys(page_dir, (void*)virt, frame, VMM_WRITABLE)) {
+            if (frame) {
+                pmm_free_frame(frame);
+            }
+            console_puts("[VMALLOC] Failed to back area with frames\n");
+            vm_unmap_pages(area->addr, i);
+            irq = irq_save();
+            vm_release(area);
+            irq_restore(irq);
+            return NULL;
+        }
+        if (i == 0) {
+            // vfree에서 주소 -> 구간 역참조
+            page_t* page = phys_to_page(frame);
+            if (page) {
+                page->private = (uintptr_t)area;
+            }
+        }
+    }
+
+    irq = irq_save();
+    area->mapped = mapped;
+    used_pages += mapped;
+    irq_restore(irq);
+
+    return (void*)area->addr;
+}
+
+bool vfree(void* addr) {
+    uintptr_t virt = (uintptr_t)addr;
+    if (virt < VMM_VMALLOC_START || virt >= VMM_VMALLOC_END || (virt & (PAGE_SIZE - 1))) {
+        console_puts("[VFREE] Address outside vmalloc area\n");
+        return false;
+    }
+
+    phys_addr_t frame = vmm_lookup_phys(vmm_get_kernel_page_dir(), addr);
+    page_t* page = frame ? phys_to_page(frame) : NULL;
+    vm_area_t* area = page ? (vm_area_t*)page->private : NULL;
+
+    uint32_t irq = irq_save();
+    if (!area || area->addr != virt || area->is_free || area->mapped == 0) {
+        irq_restore(irq);
+        console_puts("[VFREE] Not a vmalloc address\n");
+        return false;
+    }
+    uint32_t mapped = area->mapped;
+    area->mapped = 0;
+    used_pages -= mapped;
+    irq_restore(irq);
+
+    vm_unmap_pages(area->addr, mapped);
+
+    irq = irq_save();
+    vm_release(area);
+    irq_restore(irq);
+    return true;
+}
+
+uint32_t vmalloc_used_pages(void) {
+    return used_pages;
+}
+
+uint32_t vmalloc_free_pages(void) {
+    return free_pages;
+}
@@ -1,22 +1,79 @@
 #include "mem/vmm.h"
 #include "mem/pmm.h"
+#include "mem/page.h"
+#include "arch/x86/irqflags.h"
 #include "drivers/console/console.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
 
-// Simple memset implementation (string.h may not be available)
-static void* memset(void* s, int c, size_t n) {
-    uint8_t* p = (uint8_t*)s;
-    for (size_t i = 0; i < n; i++) {
-        p[i] = (uint8_t)c;
+static void console_putu32(uint32_t v) {
+    char buf[11];
+    int idx = 0;
+
+    if (v == 0) {
+        console_putc('0');
+        return;
+    }
+
+    while (v > 0 && idx < 10) {
+        buf[idx++] = (char)('0' + (v % 10));
+        v /= 10;
+    }
+
+    while (idx--) {
+        console_putc(buf[idx]);
     }
-    return s;
 }
 
 // Currently active page directory
 static void* current_page_dir = NULL;
 
+// vmm_init이 만든 커널 페이지 디렉토리
+static void* kernel_page_dir = NULL;
+
+// 페이징 모드 (vmm_init에서 AUTO가 실제 모드로 결정됨)
+static vmm_paging_mode_t paging_mode = VMM_PAGING_AUTO;
+
+// 커널 페이지 디렉토리가 CR3에 올라가 자기 참조 창을 쓸 수 있는지
+// 그 전(부팅 페이지 디렉토리)에는 페이지 테이블 프레임을 부팅 physmap으로 만짐
+static bool selfmap_active = false;
+
+// CR4.PGE가 켜져 있는지 (커널 절반 엔트리는 항상 VMM_GLOBAL로 만들어 둠)
+static bool global_pages = false;
+
+// 커널 매핑(physmap)을 큰 페이지로 만들었는지, physmap이 덮는 바이트 수
+static bool large_pages = false;
+static uint32_t physmap_size = 0;
+
+// I/O 매핑 창에서 다음으로 내줄 가상 주소
+static uint32_t ioremap_next = VMM_IOREMAP_START;
+
+// vmm_init 전에 받은 I/O 매핑 요청 (vmm_init이 커널 페이지 디렉토리에 다시 매핑)
+#define VMM_EARLY_IOREMAP_MAX 4u
+static struct {
+    uint32_t virt;
+    uint64_t phys;
+    uint32_t size;
+} early_iomaps[VMM_EARLY_IOREMAP_MAX];
+static uint32_t early_iomap_count = 0;
+
+#define LEGACY_LARGE_PAGE_SIZE 0x400000u    // PSE 4MB
+#define PAE_LARGE_PAGE_SIZE    0x200000u    // PAE 2MB
+
+// 자기 참조 창 (vmm.h의 주소 배치 참고)
+#define LEGACY_SELFMAP_INDEX 1023u
+#define LEGACY_SELFMAP_BASE  0xFFC00000u
+#define LEGACY_SELFMAP_DIR   0xFFFFF000u
+#define PAE_SELFMAP_INDEX    508u          // PD3에서 PD0..3을 가리키는 첫 엔트리
+#define PAE_SELFMAP_BASE     0xFF800000u
+#define PAE_SELFMAP_DIRS     0xFFFFC000u
+
+// 고정 매핑 창 슬롯 (다른 주소 공간의 페이지 테이블 프레임을 잠깐 매핑)
+#define VMM_WINDOW_DIR   0u     // 대상 PD (PAE: PDPT 또는 PD)
+#define VMM_WINDOW_TABLE 1u     // 대상 PT
+#define VMM_WINDOW_SRC   2u     // 복사 원본 (커널 PD가 현재 주소 공간이 아닐 때)
+
 // Page directory/table entry type
 typedef uint32_t page_entry_t;
 
@@ -26,6 +83,27 @@ typedef page_entry_t* page_dir_t;
 
 // Assembly function to set page directory in CR3 register
 extern void vmm_flush(void* page_dir);
+// 페이징을 잠깐 끄고 CR4/CR3를 바꿈 (.boot.text, identity 매핑된 곳에서 실행)
+extern void vmm_paging_reload(uint32_t cr3, uint32_t cr4);
+
+#define CR4_PAE 0x20u
+#define CR4_PGE 0x80u
+
+static inline uint32_t vmm_read_cr4(void) {
+    uint32_t cr4;
+    __asm__ __volatile__("mov %%cr4, %0" : "=r"(cr4));
+    return cr4;
+}
+
+static inline void vmm_write_cr4(uint32_t cr4) {
+    __asm__ __volatile__("mov %0, %%cr4" : : "r"(cr4) : "memory");
+}
+
+static inline uint32_t vmm_read_cr3(void) {
+    uint32_t cr3;
+    __asm__ __volatile__("mov %%cr3, %0" : "=r"(cr3));
+    return cr3;
+}
 
 // Extract physical address from page entry
 static inline void* entry_get_addr(page_entry_t entry) {
@@ -42,177 +120,601 @@ static inline bool entry_is_present(page_entry_t entry) {
     return (entry & VMM_PRESENT) != 0;
 }
 
-// Allocate page table (uses PMM)
-void* vmm_alloc_page_table(void) {
-    void* page = pmm_alloc_page();
-    if (page) {
-        // Verify 4KB alignment
-        if ((uint32_t)page & 0xFFF) {
+// PAE 엔트리 (64비트, 물리 주소 비트 12~35)
+typedef uint64_t pae_entry_t;
+
+#define PAE_ADDR_MASK 0x0000000FFFFFF000ull
+
+static inline uint64_t pae_entry_get_addr(pae_entry_t entry) {
+    return entry & PAE_ADDR_MASK;
+}
+
+static inline pae_entry_t pae_entry_create(uint64_t phys_addr, uint32_t flags) {
+    return (phys_addr & PAE_ADDR_MASK) | (flags & 0xFFF);
+}
+
+// 32비트 CPU에서 64비트 엔트리는 두 번에 나눠 써짐
+// 켤 때는 상위 절반을 먼저 써서 present 비트가 보일 때 주소가 완성되어 있게 하고,
+// 끌 때는 present가 있는 하위 절반을 먼저 지움
+static inline void pae_entry_set(pae_entry_t* entry, pae_entry_t value) {
+    volatile uint32_t* half = (volatile uint32_t*)entry;
+    half[1] = (uint32_t)(value >> 32);
+    half[0] = (uint32_t)value;
+}
+
+static inline void pae_entry_clear(pae_entry_t* entry) {
+    volatile uint32_t* half = (volatile uint32_t*)entry;
+    half[0] = 0;
+    half[1] = 0;
+}
+
+// CPUID.01h:EDX bit 6 = PAE 지원
+bool vmm_cpu_has_pae(void) {
+    uint32_t eax = 1, ebx, ecx, edx;
+    __asm__ __volatile__("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx & (1u << 6)) != 0;
+}
+
+// CPUID.01h:EDX bit 3 = PSE (legacy 4MB 페이지, PAE의 2MB 페이지는 PAE만 있으면 됨)
+static bool vmm_cpu_has_pse(void) {
+    uint32_t eax = 1, ebx, ecx, edx;
+    __asm__ __volatile__("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx & (1u << 3)) != 0;
+}
+
+// CPUID.01h:EDX bit 13 = PGE (전역 페이지)
+bool vmm_cpu_has_pge(void) {
+    uint32_t eax = 1, ebx, ecx, edx;
+    __asm__ __volatile__("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx & (1u << 13)) != 0;
+}
+
+// CR4.PGE를 바꾸면 전역 엔트리를 포함해 TLB 전체가 비워짐
+bool vmm_set_global_pages(bool enable) {
+    if (!vmm_cpu_has_pge()) {
+        return false;
+    }
+
+    uint32_t irq = irq_save();
+    uint32_t cr4 = vmm_read_cr4();
+    vmm_write_cr4(enable ? (cr4 | CR4_PGE) : (cr4 & ~CR4_PGE));
+    global_pages = enable;
+    irq_restore(irq);
+    return true;
+}
+
+bool vmm_global_pages_enabled(void) {
+    return global_pages;
+}
+
+uint32_t vmm_physmap_size(void) {
+    return physmap_size;
+}
+
+bool vmm_uses_large_pages(void) {
+    return large_pages;
+}
+
+// vmm_init 전에만 바꿀 수 있음 (이미 켜진 페이징 구조는 바꾸지 않음)
+void vmm_set_paging_mode(vmm_paging_mode_t mode) {
+    if (current_page_dir) {
+        return;
+    }
+    paging_mode = mode;
+}
+
+vmm_paging_mode_t vmm_get_paging_mode(void) {
+    return paging_mode;
+}
+
+// 현재 주소 공간의 TLB 엔트리 하나 무효화
+static inline void vmm_invlpg(void* virt_addr) {
+    __asm__ __volatile__("invlpg (%0)" : : "r"(virt_addr) : "memory");
+}
+
+// virt를 덮는 PT가 자기 참조 창에 보이는 주소 (현재 주소 공간 전용)
+static inline uintptr_t legacy_selfmap_table(uint32_t virt) {
+    return LEGACY_SELFMAP_BASE + VMM_PAGE_DIR_INDEX(virt) * VMM_PAGE_SIZE;
+}
+
+static inline uintptr_t pae_selfmap_table(uint32_t virt) {
+    return PAE_SELFMAP_BASE + (virt >> 21) * VMM_PAGE_SIZE;
+}
+
+// 현재 주소 공간의 고정 매핑 PT에서 slot 엔트리를 바꿔 frame을 보이게 함
+// 호출자는 인터럽트를 막은 상태여야 함 (창은 CPU 하나에 슬롯별로 하나뿐)
+static void* vmm_window_map(uint32_t slot, uint64_t frame) {
+    uint32_t virt = VMM_FIXMAP_START + slot * VMM_PAGE_SIZE;
+
+    if (paging_mode == VMM_PAGING_PAE) {
+        pae_entry_t* table = (pae_entry_t*)pae_selfmap_table(virt);
+        pae_entry_set(&table[VMM_PAE_TABLE_INDEX(virt)], pae_entry_create(frame, VMM_PRESENT | VMM_WRITABLE));
+    } else {
+        page_table_t table = (page_table_t)legacy_selfmap_table(virt);
+        table[VMM_PAGE_TABLE_INDEX(virt)] = entry_create((void*)(uintptr_t)frame, VMM_PRESENT | VMM_WRITABLE);
+    }
+
+    vmm_invlpg((void*)virt);
+    return (void*)virt;
+}
+
+// 페이지 테이블 프레임을 읽고 쓸 가상 주소
+//   커널 페이지 디렉토리 전    : 부팅 physmap 주소 (페이지 테이블 프레임은 NORMAL/DMA zone)
+//   page_dir가 현재 주소 공간 : 자기 참조 창 주소 selfmap_virt
+//   physmap 안의 프레임       : physmap 주소
+//   그 밖                     : 고정 매핑 창 slot
+static void* vmm_table_view(uint64_t frame, void* page_dir, uintptr_t selfmap_virt, uint32_t slot) {
+    if (!selfmap_active) {
+        return vmm_phys_to_virt(frame);
+    }
+    if (page_dir == current_page_dir && selfmap_virt) {
+        return (void*)selfmap_virt;
+    }
+    // physmap 안의 프레임은 창을 바꾸지 않고 상수 덧셈으로 바로 봄
+    if (frame < physmap_size) {
+        return vmm_phys_to_virt(frame);
+    }
+    return vmm_window_map(slot, frame);
+}
+
+// 커널 절반의 PT는 vmm_init이 모두 만들어 두고 모든 주소 공간이 같은 PT를 공유함
+// 그 뒤에 커널 절반에 PT를 새로 만들면 그 주소 공간에만 보이므로 만들지 않음
+// (physmap 중 RAM이 없는 뒷부분만 비어 있고, 거기는 매핑하지 않음)
+static inline bool vmm_may_create_table(uint32_t virt) {
+    return !kernel_page_dir || virt < VMM_USER_END;
+}
+
+// legacy: 가상 주소에 해당하는 페이지 테이블 (없으면 create일 때 새로 만듦)
+static page_table_t legacy_get_table(void* page_dir, uint32_t virt, bool create) {
+    page_dir_t dir = (page_dir_t)vmm_table_view((uintptr_t)page_dir, page_dir, LEGACY_SELFMAP_DIR, VMM_WINDOW_DIR);
+    uint32_t dir_idx = VMM_PAGE_DIR_INDEX(virt);
+    uintptr_t selfmap_table = legacy_selfmap_table(virt);
+
+    // 4MB 페이지로 매핑된 구간에는 PT가 없음
+    if (dir[dir_idx] & VMM_PAGE_SIZE_4MB) {
+        return NULL;
+    }
+
+    if (!entry_is_present(dir[dir_idx])) {
+        if (!create || !vmm_may_create_table(virt)) {
             return NULL;
         }
-        
-        // Initialize page to zero
-        memset(page, 0, VMM_PAGE_SIZE);
+
+        void* new_table = vmm_alloc_page_table();
+        if (!new_table) {
+            return NULL;
+        }
+
+        // entry_create masks lower 12 bits, so 4KB alignment is verified
+        dir[dir_idx] = entry_create(new_table, VMM_PRESENT | VMM_WRITABLE | VMM_USER);
+        if (selfmap_active && page_dir == current_page_dir) {
+            vmm_invlpg((void*)selfmap_table);
+        }
+    }
+
+    return (page_table_t)vmm_table_view((uintptr_t)entry_get_addr(dir[dir_idx]), page_dir,
+                                        selfmap_table, VMM_WINDOW_TABLE);
+}
+
+// PAE: PDPT 인덱스 pdpt_idx의 PD (현재 주소 공간이면 자기 참조 창, 아니면 PDPT를 거쳐 창으로)
+static pae_entry_t* pae_get_dir(void* page_dir, uint32_t pdpt_idx, uint32_t slot) {
+    if (selfmap_active && page_dir == current_page_dir) {
+        return (pae_entry_t*)(PAE_SELFMAP_DIRS + pdpt_idx * VMM_PAGE_SIZE);
+    }
+
+    pae_entry_t* pdpt = (pae_entry_t*)vmm_table_view((uintptr_t)page_dir, page_dir, 0, slot);
+    pae_entry_t pdpt_entry = pdpt[pdpt_idx];
+    if (!(pdpt_entry & VMM_PRESENT)) {
+        return NULL;
     }
-    return page;
+    return (pae_entry_t*)vmm_table_view(pae_entry_get_addr(pdpt_entry), page_dir, 0, slot);
 }
 
-// Free page table
+// 가상 주소에 해당하는 PAE 페이지 테이블 (없으면 create일 때 새로 만듦)
+static pae_entry_t* pae_get_table(void* page_dir, uint32_t virt, bool create) {
+    pae_entry_t* pd = pae_get_dir(page_dir, VMM_PAE_PDPT_INDEX(virt), VMM_WINDOW_DIR);
+    if (!pd) {
+        return NULL;
+    }
+
+    pae_entry_t* pd_entry = &pd[VMM_PAE_DIR_INDEX(virt)];
+    uintptr_t selfmap_table = pae_selfmap_table(virt);
+
+    // 2MB 페이지로 매핑된 구간에는 PT가 없음
+    if (*pd_entry & VMM_PAGE_SIZE_4MB) {
+        return NULL;
+    }
+
+    if (!(*pd_entry & VMM_PRESENT)) {
+        if (!create || !vmm_may_create_table(virt)) {
+            return NULL;
+        }
+
+        void* new_table = vmm_alloc_page_table();
+        if (!new_table) {
+            return NULL;
+        }
+
+        pae_entry_set(pd_entry, pae_entry_create((uintptr_t)new_table,
+                                                 VMM_PRESENT | VMM_WRITABLE | VMM_USER));
+        if (selfmap_active && page_dir == current_page_dir) {
+            vmm_invlpg((void*)selfmap_table);
+        }
+    }
+
+    return (pae_entry_t*)vmm_table_view(pae_entry_get_addr(*pd_entry), page_dir,
+                                        selfmap_table, VMM_WINDOW_TABLE);
+}
+
+// PD index가 자기 참조 창 엔트리인지 (PAE는 PD3의 마지막 4개)
+static inline bool pae_is_selfmap_entry(uint32_t pdpt_idx, uint32_t dir_idx) {
+    return pdpt_idx == VMM_PAE_PDPT_ENTRIES - 1 && dir_idx >= PAE_SELFMAP_INDEX;
+}
+
+// PAE: PDPT 1장 + PD 4장 (PDPT 엔트리는 CR3 로드 시 캐시되므로 미리 모두 채움)
+// PD3 끝 4칸은 PD0..3 자신을 가리키는 자기 참조 창
+// 커널 주소 공간이 이미 있으면 커널 절반(PD3)의 PT들을 공유해서 커널 매핑을 그대로 보이게 함
+// (커널 절반 PT는 vmm_init에서 모두 만들어 두므로 복사 이후 생기는 커널 매핑도 같은 PT에 들어감)
+// PD0..2(아래 3GB)는 비워 둠 (사용자 공간)
+static void* pae_create_page_dir(void) {
+    uint64_t pds[VMM_PAE_PDPT_ENTRIES];
+
+    void* pdpt_frame = vmm_alloc_page_table();
+    if (!pdpt_frame) {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < VMM_PAE_PDPT_ENTRIES; i++) {
+        void* pd = vmm_alloc_page_table();
+        if (!pd) {
+            while (i--) {
+                vmm_free_page_table((void*)(uintptr_t)pds[i]);
+            }
+            vmm_free_page_table(pdpt_frame);
+            return NULL;
+        }
+        pds[i] = (uintptr_t)pd;
+    }
+
+    uint32_t irq = irq_save();
+
+    // PDPT 엔트리는 R/W, U/S 비트가 예약되어 있어 Present만 설정
+    pae_entry_t* pdpt = (pae_entry_t*)vmm_table_view((uintptr_t)pdpt_frame, pdpt_frame, 0, VMM_WINDOW_DIR);
+    for (uint32_t i = 0; i < VMM_PAE_PDPT_ENTRIES; i++) {
+        pae_entry_set(&pdpt[i], pae_entry_create(pds[i], VMM_PRESENT));
+    }
+
+    for (uint32_t i = 0; i < VMM_PAE_PDPT_ENTRIES; i++) {
+        pae_entry_t* pd = (pae_entry_t*)vmm_table_view(pds[i], pdpt_frame, 0, VMM_WINDOW_TABLE);
+        pae_entry_t* kernel_pd = kernel_page_dir && i == VMM_PAE_PDPT_INDEX(VMM_USER_END)
+                                 ? pae_get_dir(kernel_page_dir, i, VMM_WINDOW_SRC) : NULL;
+
+        for (uint32_t j = 0; j < VMM_PAE_ENTRIES; j++) {
+            if (pae_is_selfmap_entry(i, j)) {
+                pae_entry_set(&pd[j], pae_entry_create(pds[j - PAE_SELFMAP_INDEX], VMM_PRESENT | VMM_WRITABLE));
+            } else if (kernel_pd && (kernel_pd[j] & VMM_PRESENT)) {
+                pae_entry_set(&pd[j], kernel_pd[j]);
+            }
+        }
+    }
+
+    irq_restore(irq);
+    return pdpt_frame;
+}
+
+static void pae_destroy_page_dir(void* page_dir) {
+    uint32_t irq = irq_save();
+
+    pae_entry_t* pdpt = (pae_entry_t*)vmm_table_view((uintptr_t)page_dir, page_dir, 0, VMM_WINDOW_DIR);
+    uint64_t pds[VMM_PAE_PDPT_ENTRIES];
+    for (uint32_t i = 0; i < VMM_PAE_PDPT_ENTRIES; i++) {
+        pds[i] = (pdpt[i] & VMM_PRESENT) ? pae_entry_get_addr(pdpt[i]) : 0;
+    }
+
+    for (uint32_t i = 0; i < VMM_PAE_PDPT_ENTRIES; i++) {
+        if (!pds[i]) {
+            continue;
+        }
+
+        // 커널 주소 공간과 공유하는 PT와 자기 참조 엔트리는 해제하지 않음
+        pae_entry_t* pd = (pae_entry_t*)vmm_table_view(pds[i], page_dir, 0, VMM_WINDOW_TABLE);
+        pae_entry_t* kernel_pd = page_dir != kernel_page_dir && kernel_page_dir
+                                 ? pae_get_dir(kernel_page_dir, i, VMM_WINDOW_SRC) : NULL;
+        for (uint32_t j = 0; j < VMM_PAE_ENTRIES; j++) {
+            if (!(pd[j] & VMM_PRESENT) || (pd[j] & VMM_PAGE_SIZE_4MB) || pae_is_selfmap_entry(i, j)) {
+                continue;
+            }
+            if (kernel_pd && pae_entry_get_addr(kernel_pd[j]) == pae_entry_get_addr(pd[j])) {
+                continue;
+            }
+            vmm_free_page_table((void*)(uintptr_t)pae_entry_get_addr(pd[j]));
+        }
+        vmm_free_page_table((void*)(uintptr_t)pds[i]);
+    }
+
+    irq_restore(irq);
+    vmm_free_page_table(page_dir);
+}
+
+static bool pae_map_page(void* page_dir, uint32_t virt, uint64_t phys, uint32_t flags) {
+    pae_entry_t* table = pae_get_table(page_dir, virt, true);
+    if (!table) {
+        return false;
+    }
+
+    pae_entry_t* entry = &table[VMM_PAE_TABLE_INDEX(virt)];
+    if (*entry & VMM_PRESENT) {
+        // Already mapped
+        return false;
+    }
+
+    pae_entry_set(entry, pae_entry_create(phys, flags | VMM_PRESENT));
+    return true;
+}
+
+static bool pae_unmap_page(void* page_dir, uint32_t virt) {
+    pae_entry_t* table = pae_get_table(page_dir, virt, false);
+    if (!table) {
+        return false;
+    }
+
+    pae_entry_t* entry = &table[VMM_PAE_TABLE_INDEX(virt)];
+    if (!(*entry & VMM_PRESENT)) {
+        return false;
+    }
+
+    pae_entry_clear(entry);
+    return true;
+}
+
+static uint64_t pae_lookup_phys(void* page_dir, uint32_t virt) {
+    pae_entry_t* pd = pae_get_dir(page_dir, VMM_PAE_PDPT_INDEX(virt), VMM_WINDOW_DIR);
+    pae_entry_t pd_entry = pd ? pd[VMM_PAE_DIR_INDEX(virt)] : 0;
+    if ((pd_entry & VMM_PRESENT) && (pd_entry & VMM_PAGE_SIZE_4MB)) {
+        return (pae_entry_get_addr(pd_entry) & ~(uint64_t)(PAE_LARGE_PAGE_SIZE - 1)) +
+               (virt & (PAE_LARGE_PAGE_SIZE - 1));
+    }
+
+    pae_entry_t* table = pae_get_table(page_dir, virt, false);
+    if (!table) {
+        return 0;
+    }
+
+    pae_entry_t entry = table[VMM_PAE_TABLE_INDEX(virt)];
+    if (!(entry & VMM_PRESENT)) {
+        return 0;
+    }
+
+    return pae_entry_get_addr(entry) + VMM_PAGE_OFFSET(virt);
+}
+
+// Allocate page table (uses PMM)
+// 엔트리와 CR3에 넣을 물리 주소를 void*로 돌려줌 (PMM의 physmap 포인터가 아님)
+// 커널 페이지 디렉토리 전에는 부팅 physmap으로 내용을 만지므로 NORMAL/DMA zone 프레임을 받음
+// zero 풀에서 이미 지워진 프레임을 받으므로 여기서 다시 지우지 않음
+void* vmm_alloc_page_table(void) {
+    void* page = pmm_alloc_zeroed_page();
+    if (!page) {
+        return NULL;
+    }
+
+    // Verify 4KB alignment
+    if ((uint32_t)page & 0xFFF) {
+        pmm_free_page(page);
+        return NULL;
+    }
+
+    page_set_flag(virt_to_page(page), PAGE_FLAG_PAGETABLE);
+    return (void*)(uintptr_t)vmm_virt_to_phys(page);
+}
+
+// Free page table (vmm_alloc_page_table이 준 물리 주소)
 void vmm_free_page_table(void* page_table) {
     if (page_table) {
-        pmm_free_page(page_table);
+        pmm_free_page(vmm_phys_to_virt((uintptr_t)page_table));
+    }
+}
+
+// legacy: PD 1장, 마지막 엔트리는 PD 자신을 가리키는 자기 참조 창
+// 커널 주소 공간이 이미 있으면 커널 절반(0xC0000000 위)의 PT들을 공유해서 커널 매핑을 그대로 보이게 함
+// (커널 절반 PT는 vmm_init에서 모두 만들어 두므로 복사 이후 생기는 커널 매핑도 같은 PT에 들어감)
+// 아래 3GB는 비워 둠 (사용자 공간)
+static void* legacy_create_page_dir(void) {
+    void* page_dir = vmm_alloc_page_table();
+    if (!page_dir) {
+        return NULL;
+    }
+
+    uint32_t irq = irq_save();
+    page_dir_t dir = (page_dir_t)vmm_table_view((uintptr_t)page_dir, page_dir, 0, VMM_WINDOW_DIR);
+    if (kernel_page_dir) {
+        page_dir_t kernel_dir = (page_dir_t)vmm_table_view((uintptr_t)kernel_page_dir, kernel_page_dir,
+                                                           LEGACY_SELFMAP_DIR, VMM_WINDOW_SRC);
+        for (uint32_t i = VMM_PAGE_DIR_INDEX(VMM_USER_END); i < LEGACY_SELFMAP_INDEX; i++) {
+            dir[i] = kernel_dir[i];
+        }
+    }
+    dir[LEGACY_SELFMAP_INDEX] = entry_create(page_dir, VMM_PRESENT | VMM_WRITABLE);
+    irq_restore(irq);
+
+    return page_dir;
+}
+
+static void legacy_destroy_page_dir(void* page_dir) {
+    uint32_t irq = irq_save();
+
+    page_dir_t dir = (page_dir_t)vmm_table_view((uintptr_t)page_dir, page_dir, 0, VMM_WINDOW_DIR);
+    page_dir_t kernel_dir = NULL;
+    if (kernel_page_dir && page_dir != kernel_page_dir) {
+        kernel_dir = (page_dir_t)vmm_table_view((uintptr_t)kernel_page_dir, kernel_page_dir,
+                                                LEGACY_SELFMAP_DIR, VMM_WINDOW_SRC);
+    }
+
+    // Free all page tables (커널과 공유하는 PT와 자기 참조 엔트리는 제외)
+    for (uint32_t i = 0; i < LEGACY_SELFMAP_INDEX; i++) {
+        if (!entry_is_present(dir[i]) || (dir[i] & VMM_PAGE_SIZE_4MB)) {
+            continue;
+        }
+        if (kernel_dir && entry_get_addr(kernel_dir[i]) == entry_get_addr(dir[i])) {
+            continue;
+        }
+        vmm_free_page_table(entry_get_addr(dir[i]));
     }
+
+    irq_restore(irq);
+
+    // Free the page directory itself
+    vmm_free_page_table(page_dir);
 }
 
 // Create page directory
+// PAE 모드에서는 PDPT를 돌려줌 (CR3에 그대로 들어가는 최상위 테이블)
 void* vmm_create_page_dir(void) {
-    void* page_dir = vmm_alloc_page_table();
+    void* page_dir = paging_mode == VMM_PAGING_PAE ? pae_create_page_dir()
+                                                   : legacy_create_page_dir();
     if (!page_dir) {
         console_puts("[VMM] Failed to allocate page directory\n");
         return NULL;
     }
     
-    // All entries are initialized to zero (already set by memset)
-    // First page table must always exist (for identity mapping)
-    
     return page_dir;
 }
 
-// Destroy page directory
+// Destroy page directory (사용 중인 주소 공간은 해제하지 않음)
 void vmm_destroy_page_dir(void* page_dir) {
-    if (!page_dir) return;
-    
-    page_dir_t dir = (page_dir_t)page_dir;
-    
-    // Free all page tables
-    for (uint32_t i = 0; i < VMM_PAGE_DIR_ENTRIES; i++) {
-        if (entry_is_present(dir[i])) {
-            void* page_table = entry_get_addr(dir[i]);
-            vmm_free_page_table(page_table);
-        }
+    if (!page_dir || page_dir == current_page_dir) return;
+
+    if (paging_mode == VMM_PAGING_PAE) {
+        pae_destroy_page_dir(page_dir);
+    } else {
+        legacy_destroy_page_dir(page_dir);
     }
     
-    // Free the page directory itself
-    vmm_free_page_table(page_dir);
-    
     console_puts("[VMM] Page directory destroyed\n");
 }
 
 // Map page
 bool vmm_map_page(void* page_dir, void* virt_addr, void* phys_addr, uint32_t flags) {
-    if (!page_dir || !virt_addr || !phys_addr) {
+    if (!phys_addr) {
+        return false;
+    }
+
+    return vmm_map_phys(page_dir, virt_addr, (uintptr_t)phys_addr, flags);
+}
+
+// 64비트 물리 주소 매핑 (4GB 위 프레임은 PAE 모드에서만 가능)
+// 고정 매핑/자기 참조 창 영역은 VMM이 직접 관리하므로 거부
+bool vmm_map_phys(void* page_dir, void* virt_addr, uint64_t phys_addr, uint32_t flags) {
+    if (!page_dir || !virt_addr || (uint32_t)virt_addr >= VMM_FIXMAP_START) {
         return false;
     }
     
     // Verify virtual address alignment
-    if (((uint32_t)virt_addr & 0xFFF) != 0 || ((uint32_t)phys_addr & 0xFFF) != 0) {
+    if (((uint32_t)virt_addr & 0xFFF) != 0 || (phys_addr & 0xFFF) != 0) {
         return false;
     }
-    
-    page_dir_t dir = (page_dir_t)page_dir;
-    uint32_t dir_idx = VMM_PAGE_DIR_INDEX(virt_addr);
-    uint32_t table_idx = VMM_PAGE_TABLE_INDEX(virt_addr);
-    
-    if (dir_idx >= VMM_PAGE_DIR_ENTRIES || table_idx >= VMM_PAGE_TABLE_ENTRIES) {
+
+    if (paging_mode != VMM_PAGING_PAE && phys_addr >= PMM_LOW_LIMIT) {
         return false;
     }
-    
-    // Check page directory entry
-    page_entry_t dir_entry = dir[dir_idx];
-    
-    page_table_t table;
-    if (!entry_is_present(dir_entry)) {
-        // Create page table if it doesn't exist
-        // pmm_alloc_page() returns physical address (before paging enabled, virtual = physical)
-        void* new_table_phys = vmm_alloc_page_table();
-        if (!new_table_phys) {
-            return false;
-        }
-        
-        // Store physical address in page directory entry (physical address needed for CR3)
-        // entry_create masks lower 12 bits, so 4KB alignment is verified
-        dir[dir_idx] = entry_create(new_table_phys, VMM_PRESENT | VMM_WRITABLE | VMM_USER);
-        
-        // Before paging is enabled, we can access physical address directly
-        table = (page_table_t)new_table_phys;
-    } else {
-        // Use existing page table
-        table = (page_table_t)entry_get_addr(dir_entry);
+
+    // 커널 절반 PT는 모든 주소 공간이 공유하므로 (vmm_init에서 미리 만듦) 전역 페이지로 만들어도
+    // 어느 CR3에서나 같은 변환이 됨 (CR4.PGE가 꺼져 있으면 무시됨)
+    if ((uint32_t)virt_addr >= VMM_USER_END) {
+        flags |= VMM_GLOBAL;
     }
-    
-    // Set page table entry
-    if (entry_is_present(table[table_idx])) {
-        // Already mapped
-        return false;
+
+    uint32_t irq = irq_save();
+    bool mapped;
+    if (paging_mode == VMM_PAGING_PAE) {
+        mapped = pae_map_page(page_dir, (uint32_t)virt_addr, phys_addr, flags);
+    } else {
+        page_table_t table = legacy_get_table(page_dir, (uint32_t)virt_addr, true);
+        uint32_t table_idx = VMM_PAGE_TABLE_INDEX(virt_addr);
+
+        // Already mapped이면 실패
+        mapped = table && !entry_is_present(table[table_idx]);
+        if (mapped) {
+            table[table_idx] = entry_create((void*)(uintptr_t)phys_addr, flags | VMM_PRESENT);
+        }
     }
-    
-    table[table_idx] = entry_create(phys_addr, flags | VMM_PRESENT);
-    
-    return true;
+    irq_restore(irq);
+
+    return mapped;
 }
 
 // Unmap page
 bool vmm_unmap_page(void* page_dir, void* virt_addr) {
-    if (!page_dir || !virt_addr) {
-        return false;
-    }
-    
-    page_dir_t dir = (page_dir_t)page_dir;
-    uint32_t dir_idx = VMM_PAGE_DIR_INDEX(virt_addr);
-    uint32_t table_idx = VMM_PAGE_TABLE_INDEX(virt_addr);
-    
-    if (dir_idx >= VMM_PAGE_DIR_ENTRIES || table_idx >= VMM_PAGE_TABLE_ENTRIES) {
+    if (!page_dir || !virt_addr || (uint32_t)virt_addr >= VMM_FIXMAP_START) {
         return false;
     }
-    
-    page_entry_t dir_entry = dir[dir_idx];
-    if (!entry_is_present(dir_entry)) {
-        return false;
+
+    uint32_t irq = irq_save();
+    bool unmapped;
+    if (paging_mode == VMM_PAGING_PAE) {
+        unmapped = pae_unmap_page(page_dir, (uint32_t)virt_addr);
+    } else {
+        page_table_t table = legacy_get_table(page_dir, (uint32_t)virt_addr, false);
+        uint32_t table_idx = VMM_PAGE_TABLE_INDEX(virt_addr);
+
+        unmapped = table && entry_is_present(table[table_idx]);
+        if (unmapped) {
+            // Remove page table entry
+            table[table_idx] = 0;
+        }
     }
-    
-    page_table_t table = (page_table_t)entry_get_addr(dir_entry);
-    if (!entry_is_present(table[table_idx])) {
-        return false;
+
+    // 활성 주소 공간이면 남아 있는 TLB 엔트리도 제거 (같은 주소를 다시 매핑할 때 필요)
+    // 커널 절반의 전역 엔트리는 CR3를 바꿔도 남으므로 어느 주소 공간에서 지웠든 무효화
+    if (unmapped && (page_dir == current_page_dir || (uint32_t)virt_addr >= VMM_USER_END)) {
+        vmm_invlpg(virt_addr);
     }
+    irq_restore(irq);
     
-    // Remove page table entry
-    table[table_idx] = 0;
-    
-    return true;
+    return unmapped;
 }
 
 // Get physical address from virtual address
+// 4GB 위 프레임에 매핑된 주소는 포인터로 표현할 수 없으므로 NULL
 void* vmm_get_phys_addr(void* page_dir, void* virt_addr) {
-    if (!page_dir || !virt_addr) {
+    uint64_t phys_addr = vmm_lookup_phys(page_dir, virt_addr);
+    if (phys_addr >= PMM_LOW_LIMIT) {
         return NULL;
     }
-    
-    page_dir_t dir = (page_dir_t)page_dir;
-    uint32_t dir_idx = VMM_PAGE_DIR_INDEX(virt_addr);
-    uint32_t table_idx = VMM_PAGE_TABLE_INDEX(virt_addr);
-    
-    if (dir_idx >= VMM_PAGE_DIR_ENTRIES || table_idx >= VMM_PAGE_TABLE_ENTRIES) {
-        return NULL;
-    }
-    
-    page_entry_t dir_entry = dir[dir_idx];
-    if (!entry_is_present(dir_entry)) {
-        return NULL;
+    return (void*)(uintptr_t)phys_addr;
+}
+
+// 가상 주소의 64비트 물리 주소 (매핑되지 않았으면 0)
+uint64_t vmm_lookup_phys(void* page_dir, void* virt_addr) {
+    if (!page_dir || !virt_addr) {
+        return 0;
     }
-    
-    page_table_t table = (page_table_t)entry_get_addr(dir_entry);
-    if (!entry_is_present(table[table_idx])) {
-        return NULL;
+
+    uint32_t irq = irq_save();
+    uint64_t phys_addr = 0;
+    if (paging_mode == VMM_PAGING_PAE) {
+        phys_addr = pae_lookup_phys(page_dir, (uint32_t)virt_addr);
+    } else {
+        page_dir_t dir = (page_dir_t)vmm_table_view((uintptr_t)page_dir, page_dir, LEGACY_SELFMAP_DIR, VMM_WINDOW_DIR);
+        page_entry_t dir_entry = dir[VMM_PAGE_DIR_INDEX(virt_addr)];
+        if (entry_is_present(dir_entry) && (dir_entry & VMM_PAGE_SIZE_4MB)) {
+            phys_addr = (dir_entry & ~(LEGACY_LARGE_PAGE_SIZE - 1)) +
+                        ((uint32_t)virt_addr & (LEGACY_LARGE_PAGE_SIZE - 1));
+        } else {
+            page_table_t table = legacy_get_table(page_dir, (uint32_t)virt_addr, false);
+            page_entry_t entry = table ? table[VMM_PAGE_TABLE_INDEX(virt_addr)] : 0;
+            if (entry_is_present(entry)) {
+                phys_addr = (uint32_t)entry_get_addr(entry) + VMM_PAGE_OFFSET(virt_addr);
+            }
+        }
     }
-    
-    void* phys_addr = entry_get_addr(table[table_idx]);
-    uint32_t offset = VMM_PAGE_OFFSET(virt_addr);
-    
-    return (void*)((uint32_t)phys_addr + offset);
+    irq_restore(irq);
+
+    return phys_addr;
 }
 
 // Activate page directory
-// Note: page_dir must be physical address (before paging enabled, virtual = physical)
+// Note: page_dir must be physical address (CR3에 그대로 들어감)
 void vmm_switch_page_dir(void* page_dir) {
     if (!page_dir) {
         return;
@@ -234,11 +736,186 @@ void* vmm_get_current_page_dir(void) {
     return current_page_dir;
 }
 
+void* vmm_get_kernel_page_dir(void) {
+    return kernel_page_dir;
+}
+
+// 큰 페이지 하나 (PT 없이 PD 엔트리에 직접)
+static bool vmm_map_large_page(void* page_dir, uint32_t virt, uint64_t phys, uint32_t flags) {
+    flags |= VMM_PRESENT | VMM_PAGE_SIZE_4MB;
+    if (virt >= VMM_USER_END) {
+        flags |= VMM_GLOBAL;
+    }
+
+    if (paging_mode == VMM_PAGING_PAE) {
+        pae_entry_t* pd = pae_get_dir(page_dir, VMM_PAE_PDPT_INDEX(virt), VMM_WINDOW_DIR);
+        pae_entry_t* entry = pd ? &pd[VMM_PAE_DIR_INDEX(virt)] : NULL;
+        if (!entry || (*entry & VMM_PRESENT)) {
+            return false;
+        }
+        pae_entry_set(entry, pae_entry_create(phys, flags));
+    } else {
+        page_dir_t dir = (page_dir_t)vmm_table_view((uintptr_t)page_dir, page_dir, LEGACY_SELFMAP_DIR, VMM_WINDOW_DIR);
+        uint32_t dir_idx = VMM_PAGE_DIR_INDEX(virt);
+        if (entry_is_present(dir[dir_idx])) {
+            return false;
+        }
+        dir[dir_idx] = entry_create((void*)(uintptr_t)phys, flags);
+    }
+    return true;
+}
+
+// [virt, virt + size)를 phys부터 선형 매핑, 실패한 4KB 페이지 수를 돌려줌
+// 큰 페이지를 쓸 수 있으면 정렬이 맞는 구간은 큰 페이지로 (PT 메모리와 TLB 엔트리를 아낌)
+static uint32_t vmm_map_linear(void* page_dir, uint32_t virt, uint64_t phys, uint32_t size, uint32_t flags) {
+    uint32_t large = paging_mode == VMM_PAGING_PAE ? PAE_LARGE_PAGE_SIZE : LEGACY_LARGE_PAGE_SIZE;
+    uint32_t failed = 0;
+    uint32_t offset = 0;
+
+    while (offset < size) {
+        uint32_t v = virt + offset;
+        uint64_t p = phys + offset;
+
+        if (large_pages && (v & (large - 1)) == 0 && (p & (large - 1)) == 0 && size - offset >= large) {
+            if (!vmm_map_large_page(page_dir, v, p, flags)) {
+                failed += large / VMM_PAGE_SIZE;
+            }
+            offset += large;
+        } else {
+            if (!vmm_map_phys(page_dir, (void*)v, p, flags)) {
+                failed++;
+            }
+            offset += VMM_PAGE_SIZE;
+        }
+    }
+
+    return failed;
+}
+
+// vmm_init 전: 부팅 페이지 디렉토리(legacy, 4MB 페이지)에 바로 매핑
+// 4MB 페이지라 가상 주소도 4MB 안의 오프셋이 물리 주소와 같도록 잡음
+static void* vmm_ioremap_early(uint64_t start, uint32_t span) {
+    uint32_t large = LEGACY_LARGE_PAGE_SIZE;
+    uint32_t virt = ((ioremap_next + large - 1) & ~(large - 1)) + (uint32_t)(start & (large - 1));
+
+    if (early_iomap_count >= VMM_EARLY_IOREMAP_MAX || start + span > PMM_LOW_LIMIT ||
+        virt + span > VMM_IOREMAP_END || virt + span < virt) {
+        return NULL;
+    }
+
+    page_dir_t boot_dir = (page_dir_t)vmm_phys_to_virt(vmm_read_cr3() & 0xFFFFF000u);
+    uint32_t phys_base = (uint32_t)start & ~(large - 1);
+    for (uint32_t v = virt & ~(large - 1); v < virt + span; v += large, phys_base += large) {
+        boot_dir[VMM_PAGE_DIR_INDEX(v)] = phys_base | VMM_PRESENT | VMM_WRITABLE | VMM_PAGE_SIZE_4MB;
+        vmm_invlpg((void*)v);
+    }
+
+    early_iomaps[early_iomap_count].virt = virt;
+    early_iomaps[early_iomap_count].phys = start;
+    early_iomaps[early_iomap_count].size = span;
+    early_iomap_count++;
+    ioremap_next = virt + span;
+    return (void*)virt;
+}
+
+// [virt, virt + span)을 start부터 4KB 페이지로 매핑 (커널 절반 PT는 미리 만들어져 있음)
+// 캐시 속성은 따로 주지 않음 -> 펌웨어가 MTRR로 장치 메모리에 정한 타입(UC/WC)을 따름
+static bool vmm_ioremap_pages(void* page_dir, uint32_t virt, uint64_t start, uint32_t span) {
+    for (uint32_t offset = 0; offset < span; offset += VMM_PAGE_SIZE) {
+        if (!vmm_map_phys(page_dir, (void*)(virt + offset), start + offset, VMM_WRITABLE)) {
+            while (offset > 0) {
+                offset -= VMM_PAGE_SIZE;
+                vmm_unmap_page(page_dir, (void*)(virt + offset));
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+void* vmm_ioremap(uint64_t phys, uint32_t size) {
+    if (size == 0) {
+        return NULL;
+    }
+
+    uint64_t start = phys & ~(uint64_t)(VMM_PAGE_SIZE - 1);
+    uint64_t end = (phys + size + VMM_PAGE_SIZE - 1) & ~(uint64_t)(VMM_PAGE_SIZE - 1);
+    if (end - start > VMM_IOREMAP_END - VMM_IOREMAP_START) {
+        return NULL;
+    }
+    uint32_t span = (uint32_t)(end - start);
+    uint32_t offset = (uint32_t)(phys - start);
+
+    if (!selfmap_active) {
+        uint8_t* virt = (uint8_t*)vmm_ioremap_early(start, span);
+        return virt ? virt + offset : NULL;
+    }
+
+    uint32_t irq = irq_save();
+    uint32_t virt = ioremap_next;
+    bool fits = span <= VMM_IOREMAP_END - virt;
+    if (fits) {
+        ioremap_next += span;
+    }
+    irq_restore(irq);
+
+    if (!fits || !vmm_ioremap_pages(kernel_page_dir, virt, start, span)) {
+        return NULL;
+    }
+    return (uint8_t*)(uintptr_t)virt + offset;
+}
+
+// physmap 뒤 [VMM_PHYSMAP_END, 자기 참조 창)의 비어 있는 PD 엔트리마다 빈 PT를 만들어 둠
+// (커널 힙, vmalloc, 고정 매핑 창) 만든 PT 수 반환, 메모리가 모자라면 UINT32_MAX
+static uint32_t vmm_prealloc_kernel_tables(void* page_dir) {
+    uint32_t step = paging_mode == VMM_PAGING_PAE ? PAE_LARGE_PAGE_SIZE : LEGACY_LARGE_PAGE_SIZE;
+    uint32_t created = 0;
+
+    for (uint32_t virt = VMM_PHYSMAP_END; virt < VMM_SELFMAP_START; virt += step) {
+        bool present;
+        if (paging_mode == VMM_PAGING_PAE) {
+            pae_entry_t* pd = pae_get_dir(page_dir, VMM_PAE_PDPT_INDEX(virt), VMM_WINDOW_DIR);
+            present = (pd[VMM_PAE_DIR_INDEX(virt)] & VMM_PRESENT) != 0;
+        } else {
+            page_dir_t dir = (page_dir_t)vmm_table_view((uintptr_t)page_dir, page_dir, 0, VMM_WINDOW_DIR);
+            present = entry_is_present(dir[VMM_PAGE_DIR_INDEX(virt)]);
+        }
+        if (present) {
+            continue;
+        }
+
+        bool ok = paging_mode == VMM_PAGING_PAE ? pae_get_table(page_dir, virt, true) != NULL
+                                                : legacy_get_table(page_dir, virt, true) != NULL;
+        if (!ok) {
+            return UINT32_MAX;
+        }
+        created++;
+    }
+
+    return created;
+}
+
 // VMM initialization
 void vmm_init(void) {
     console_puts("[VMM] Initializing Virtual Memory Manager...\n");
+
+    // 페이징 모드 결정: 4GB 위에 관리할 메모리가 있으면 PAE
+    bool has_pae = vmm_cpu_has_pae();
+    if (paging_mode == VMM_PAGING_AUTO) {
+        paging_mode = (has_pae && pmm_memory_end() > PMM_LOW_LIMIT) ? VMM_PAGING_PAE
+                                                                    : VMM_PAGING_LEGACY;
+    } else if (paging_mode == VMM_PAGING_PAE && !has_pae) {
+        console_puts("[VMM] CPU does not support PAE, falling back to legacy paging\n");
+        paging_mode = VMM_PAGING_LEGACY;
+    }
+
+    if (paging_mode == VMM_PAGING_PAE) {
+        console_puts("[VMM] Paging mode: PAE (3-level, 64-bit entries)\n");
+    } else {
+        console_puts("[VMM] Paging mode: legacy (2-level, 32-bit entries)\n");
+    }
     
-    // Create page directory (returns physical address, before paging enabled virtual = physical)
+    // Create page directory (returns physical address)
     void* page_dir = vmm_create_page_dir();
     if (!page_dir) {
         console_puts("[VMM] Failed to create initial page directory\n");
@@ -251,68 +928,104 @@ void vmm_init(void) {
         return;
     }
     
-    // Identity mapping: virtual address = physical address
-    // Stack is at 0x900000 (9MB), so need at least 10MB of identity mapping
-    // Map 16MB for safety (4096 pages)
-    console_puts("[VMM] Creating identity mapping for first 16MB...\n");
-    
-    uint32_t identity_pages = 4096; // 16MB / 4KB = 4096 pages
-    uint32_t failed_count = 0;
-    
-    for (uint32_t i = 0; i < identity_pages; i++) {
-        void* virt_addr = (void*)(i * VMM_PAGE_SIZE);
-        void* phys_addr = virt_addr; // identity mapping
-        
-        uint32_t flags = VMM_WRITABLE;
-        if (i < 256) { // First 1MB is kernel area, user mode access not allowed
-            flags &= ~VMM_USER;
-        } else {
-            flags |= VMM_USER;
-        }
-        
-        if (!vmm_map_page(page_dir, virt_addr, phys_addr, flags)) {
-            failed_count++;
-        }
+    // 큰 페이지: PAE는 2MB 페이지가 기본 제공, legacy는 PSE가 있어야 4MB 페이지
+    // (부팅 트램펄린이 PSE를 요구하므로 legacy에서도 사실상 항상 켜짐)
+    large_pages = paging_mode == VMM_PAGING_PAE || vmm_cpu_has_pse();
+
+    // physmap: 물리 주소 0부터 DMA/NORMAL zone 끝까지 VMM_PHYSMAP_START에 선형 매핑 (최소 16MB)
+    // 커널 이미지, 부팅 스택, PMM 포인터가 모두 이 안에 있음
+    // identity 매핑은 만들지 않음 -> 아래 3GB는 사용자 공간으로 비워 둠 (0번 페이지 포함)
+    uint64_t physmap_end = pmm_direct_map_end();
+    if (physmap_end < PMM_DMA_LIMIT) {
+        physmap_end = PMM_DMA_LIMIT;
+    }
+    physmap_size = (uint32_t)physmap_end;
+    if (physmap_size > VMM_PHYSMAP_END - VMM_PHYSMAP_START) {
+        physmap_size = VMM_PHYSMAP_END - VMM_PHYSMAP_START;
     }
+
+    console_puts("[VMM] Creating physmap for DMA/Normal zones (");
+    console_putu32(physmap_size >> 20);
+    console_puts(large_pages ? " MB, large pages)...\n" : " MB, 4KB pages)...\n");
+
+    uint32_t failed_count = vmm_map_linear(page_dir, VMM_PHYSMAP_START, 0, physmap_size, VMM_WRITABLE);
     
     if (failed_count > 0) {
         console_puts("[VMM] Warning: Failed to map ");
-        uint32_t count = failed_count;
-        char buf[12];
-        int idx = 0;
-        if (count == 0) {
-            console_putc('0');
-        } else {
-            while (count > 0 && idx < 11) {
-                buf[idx++] = (char)('0' + (count % 10));
-                count /= 10;
-            }
-            while (idx--) console_putc(buf[idx]);
-        }
+        console_putu32(failed_count);
         console_puts(" pages\n");
     }
+
+    // 커널 절반의 나머지 PT를 모두 미리 만들어 둠 (고정 매핑 창의 PT 포함)
+    // 주소 공간은 만들 때 커널 PD 엔트리를 복사하므로, 이후 커널 힙/vmalloc 매핑이 늘어도
+    // 이미 공유 중인 PT 안에서만 바뀌어 모든 주소 공간에 똑같이 보임
+    uint32_t kernel_tables = vmm_prealloc_kernel_tables(page_dir);
+    if (kernel_tables == UINT32_MAX) {
+        console_puts("[VMM] Failed to allocate kernel page tables\n");
+        return;
+    }
+    console_puts("[VMM] Preallocated ");
+    console_putu32(kernel_tables);
+    console_puts(" kernel page tables (");
+    console_putu32(kernel_tables * 4);
+    console_puts(" KB)\n");
+
+    // vmm_init 전에 매핑한 장치 메모리(프레임버퍼 등)를 같은 가상 주소로 커널 쪽에도 매핑
+    // 부팅 페이지 디렉토리를 버린 뒤에도 그 주소를 계속 쓸 수 있음
+    for (uint32_t i = 0; i < early_iomap_count; i++) {
+        if (!vmm_ioremap_pages(page_dir, early_iomaps[i].virt, early_iomaps[i].phys, early_iomaps[i].size)) {
+            console_puts("[VMM] Failed to carry over boot I/O mapping\n");
+            return;
+        }
+    }
+
+    // 부팅 페이지 디렉토리(4MB identity + physmap)에서 커널 페이지 디렉토리로 전환
+    // 커널 코드/스택은 두 주소 공간 모두에서 physmap 안에 있으므로 CR3만 바꾸면 됨
+    kernel_page_dir = page_dir;
+    if (paging_mode == VMM_PAGING_PAE) {
+        // CR4.PAE는 페이징을 끈 상태에서만 바꿀 수 있으므로 identity 매핑된 .boot.text에서 전환
+        // 그동안만 그 코드 페이지를 새 주소 공간에도 identity 매핑해 둠
+        uint32_t reload_page = (uint32_t)(uintptr_t)vmm_paging_reload & ~(VMM_PAGE_SIZE - 1);
+        if (!vmm_map_phys(page_dir, (void*)reload_page, reload_page, 0)) {
+            console_puts("[VMM] Failed to map paging reload trampoline\n");
+            kernel_page_dir = NULL;
+            return;
+        }
+
+        current_page_dir = page_dir;
+        vmm_paging_reload((uint32_t)(uintptr_t)page_dir, vmm_read_cr4() | CR4_PAE);
+        selfmap_active = true;
+
+        // 트램펄린 매핑과 그 PT를 걷어내 아래 3GB를 비움
+        vmm_unmap_page(page_dir, (void*)reload_page);
+        pae_entry_t* pd = pae_get_dir(page_dir, VMM_PAE_PDPT_INDEX(reload_page), VMM_WINDOW_DIR);
+        pae_entry_t* pd_entry = &pd[VMM_PAE_DIR_INDEX(reload_page)];
+        void* table = (void*)(uintptr_t)pae_entry_get_addr(*pd_entry);
+        pae_entry_clear(pd_entry);
+        vmm_invlpg((void*)pae_selfmap_table(reload_page));
+        vmm_free_page_table(table);
+    } else {
+        vmm_switch_page_dir(page_dir);
+        selfmap_active = true;
+    }
     
-    // Activate page directory
-    vmm_switch_page_dir(page_dir);
-    
-    // Enable paging (set CR0.PG bit)
-    // Note: Code executed immediately after paging enable must be within identity mapping range
-    uint32_t cr0;
-    __asm__ __volatile__("mov %%cr0, %0" : "=r"(cr0));
-    cr0 |= 0x80000000; // PG bit (bit 31)
-    
-    // Enable paging safely using inline assembly
-    // Note: Code executed immediately after paging enable must be within identity mapping range
-    __asm__ __volatile__(
-        "mov %0, %%cr0\n\t"      // Set PG bit in CR0
-        "jmp 1f\n\t"             // Jump after paging enable (pipeline flush)
-        "1:\n\t"                 // Continue execution here
-        "nop\n\t"                // Safety NOP
-        :
-        : "r"(cr0)
-        : "memory", "cc"
-    );
-    
-    console_puts("[VMM] Paging enabled\n");
+    console_puts("[VMM] Kernel page directory active (boot identity mapping dropped)\n");
+
+    // 커널 절반 매핑은 VMM_GLOBAL로 만들어져 있으므로 PGE만 켜면 주소 공간 전환에도 TLB에 남음
+    // 커널 절반 PT를 위에서 모두 만들어 공유하므로 TLB에 남은 전역 엔트리가 다른 주소 공간과 어긋나지 않음
+    if (vmm_set_global_pages(true)) {
+        console_puts("[VMM] Global pages enabled for kernel mappings\n");
+    }
+
+    // 이제부터 페이지 테이블은 자기 참조 창으로만 접근
+    uintptr_t dir_view = paging_mode == VMM_PAGING_PAE ? PAE_SELFMAP_DIRS : LEGACY_SELFMAP_DIR;
+    bool selfmap_ok = vmm_lookup_phys(page_dir, vmm_phys_to_virt(0x100000)) == 0x100000 &&
+                      vmm_lookup_phys(page_dir, (void*)dir_view) != 0;
+    console_puts("[VMM] Page tables reachable through self-map: ");
+    console_puts(selfmap_ok ? "OK\n" : "FAILED\n");
+
+    console_puts("[VMM] Physmap: 0xC0000000 -> ");
+    console_putu32(physmap_size >> 20);
+    console_puts(" MB of physical memory\n");
     console_puts("[VMM] Virtual Memory Manager initialized successfully\n");
 }
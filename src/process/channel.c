@@ -1,7 +1,8 @@
 #include "process/channel.h"
 #include "process/scheduler.h"
 #include "arch/x86/idt.h"
-#include "mem/kmalloc.h"
+#include "mem/slab.h"
+#include "drivers/console/console.h"
 #include <stddef.h>
 
 typedef struct channel_wait_queue {
@@ -22,6 +23,7 @@ struct channel {
     struct channel* next;
 };
 
+static kmem_cache_t* channel_cache = NULL;
 static channel_t* channel_list = NULL;
 static uint32_t next_channel_id = 1;
 
@@ -135,12 +137,17 @@ static task_struct_t* channel_wait_queue_pop(channel_wait_queue_t* queue) {
 }
 
 void channel_init(void) {
+    channel_cache = kmem_cache_create("channel", sizeof(channel_t), 0, NULL);
+    if (!channel_cache) {
+        console_puts("[CHANNEL] Failed to create channel cache\n");
+    }
+
     channel_list = NULL;
     next_channel_id = 1;
 }
 
 channel_t* channel_create(void) {
-    channel_t* channel = (channel_t*)kmalloc(sizeof(channel_t));
+    channel_t* channel = (channel_t*)kmem_cache_alloc(channel_cache);
     if (!channel) {
         return NULL;
     }
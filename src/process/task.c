@@ -1,13 +1,23 @@
 #include "process/task.h"
 #include "process/scheduler.h"
-#include "mem/kmalloc.h"
+#include "mem/slab.h"
+#include "mem/pmm.h"
 #include "mem/vmm.h"
+#include "arch/x86/irqflags.h"
 #include "drivers/console/console.h"
 #include <stddef.h>
 
+#define TASK_KERNEL_STACK_SIZE 4096u
+#define TASK_SCRATCH_CHUNK_SIZE PAGE_SIZE
+#define TASK_HEAP_CHUNK_SIZE 2048u
+
 // 전역 변수
 static uint32_t next_pid = 1;
 
+// PCB와 커널 스택 전용 slab 캐시 (스택은 페이지 정렬)
+static kmem_cache_t* task_cache = NULL;
+static kmem_cache_t* kstack_cache = NULL;
+
 // 커널 태스크 (idle task)
 static task_struct_t kernel_task;
 
@@ -44,6 +54,12 @@ task_struct_t* task_get_kernel_task(void) {
 
 void task_init(void) {
     console_puts("[TASK] Initializing task management...\n");
+
+    task_cache = kmem_cache_create("task_struct", sizeof(task_struct_t), 0, NULL);
+    kstack_cache = kmem_cache_create("kstack", TASK_KERNEL_STACK_SIZE, PAGE_SIZE, NULL);
+    if (!task_cache || !kstack_cache) {
+        console_puts("[TASK] Failed to create task caches\n");
+    }
     
     // 커널 태스크 초기화 (PID 0)
     kernel_task.pid = 0;
@@ -69,10 +85,53 @@ void task_init(void) {
     kernel_task.cpu_time = 0;
     kernel_task.page_directory = vmm_get_current_page_dir();
     kernel_task.entry_point = NULL;
+    kernel_task.scratch = NULL;
+    kernel_task.heap = NULL;
     
     console_puts("[TASK] Kernel task initialized (PID 0)\n");
 }
 
+arena_t* task_scratch_arena(void) {
+    task_struct_t* task = scheduler_get_current_task();
+    if (!task) {
+        task = &kernel_task;
+    }
+
+    if (!task->scratch) {
+        task->scratch = arena_create(TASK_SCRATCH_CHUNK_SIZE);
+        if (!task->scratch) {
+            console_puts("[TASK] Failed to create scratch arena\n");
+        }
+    }
+    return task->scratch;
+}
+
+// 다른 태스크 몫으로도 할당할 수 있으므로 (예: 생성 직후 인자 버퍼) 선점을 막고 할당
+void* task_alloc(task_struct_t* task, size_t size) {
+    if (!task) {
+        task = scheduler_get_current_task();
+        if (!task) {
+            task = &kernel_task;
+        }
+    }
+    if (task->state == TASK_TERMINATED) {
+        return NULL;
+    }
+
+    uint32_t irq = irq_save();
+    if (!task->heap) {
+        task->heap = arena_create_heap(TASK_HEAP_CHUNK_SIZE);
+    }
+    void* ptr = task->heap ? arena_alloc(task->heap, size) : NULL;
+    irq_restore(irq);
+
+    return ptr;
+}
+
+uint32_t task_heap_bytes(const task_struct_t* task) {
+    return task ? arena_used_bytes(task->heap) : 0;
+}
+
 uint32_t task_get_next_pid(void) {
     return next_pid++;
 }
@@ -134,7 +193,7 @@ void task_exit(void) {
 
 task_struct_t* task_create(const char* name, void (*entry_point)(void), uint32_t priority) {
     // PCB 할당
-    task_struct_t* task = (task_struct_t*)kmalloc(sizeof(task_struct_t));
+    task_struct_t* task = (task_struct_t*)kmem_cache_alloc(task_cache);
     if (!task) {
         console_puts("[TASK] Failed to allocate task struct\n");
         return NULL;
@@ -160,17 +219,19 @@ task_struct_t* task_create(const char* name, void (*entry_point)(void), uint32_t
     task->creation_time = 0;  // TODO: 타이머 구현 후 실제 시간 설정
     task->cpu_time = 0;
     task->entry_point = entry_point;
+    task->scratch = NULL;
+    task->heap = NULL;
     
     // 커널 스택 할당 (4KB) - 태스크별 독립 스택
-    task->kernel_stack = (uint32_t)kmalloc(4096);
+    task->kernel_stack = (uint32_t)kmem_cache_alloc(kstack_cache);
     if (!task->kernel_stack) {
         console_puts("[TASK] Failed to allocate kernel stack\n");
-        kfree(task);
+        kmem_cache_free(task_cache, task);
         return NULL;
     }
     
     // 스택은 위에서 아래로 자라므로 스택 포인터는 끝에서 시작
-    uint32_t* stack_ptr = (uint32_t*)(task->kernel_stack + 4096);
+    uint32_t* stack_ptr = (uint32_t*)(task->kernel_stack + TASK_KERNEL_STACK_SIZE);
     
     // ✅ IRQ 프레임 구조에 맞춰 스택 초기화
     // 스택 구조 (낮은 주소 ← 높은 주소):
@@ -265,13 +326,24 @@ void task_destroy(task_struct_t* task) {
     // 큐에서 제거
     task_remove_from_ready_queue(task);
     
+    // 태스크 소유 arena 반환 (객체 수가 아니라 chunk 수만큼만 해제)
+    // chunk는 kmalloc/PMM으로 돌아가며 둘 다 안에서 irq_save로 막음
+    if (task->heap) {
+        arena_destroy(task->heap);
+        task->heap = NULL;
+    }
+    if (task->scratch) {
+        arena_destroy(task->scratch);
+        task->scratch = NULL;
+    }
+
     // 커널 스택 해제
     if (task->kernel_stack) {
-        kfree((void*)task->kernel_stack);
+        kmem_cache_free(kstack_cache, (void*)task->kernel_stack);
     }
     
     // PCB 해제
-    kfree(task);
+    kmem_cache_free(task_cache, task);
 }
 
 task_struct_t* task_get_current(void) {
@@ -0,0 +1,172 @@
+#include "hostbench.h"
+#include "mem/mmap.h"
+#include "mem/memblock.h"
+#include "mem/pmm.h"
+#include "mem/vmm.h"
+#include "mem/kmalloc.h"
+#include "drivers/console/console.h"
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// 커널이 링크 스크립트에서 받는 심볼 대신 쓰는 가짜 커널 이미지 (memblock이 예약함)
+__asm__(".pushsection .bss\n"
+        ".globl kernel_phys_start\n"
+        "kernel_phys_start:\n"
+        ".zero 4096\n"
+        ".globl kernel_phys_end\n"
+        "kernel_phys_end:\n"
+        ".popsection\n");
+
+#define HOST_PHYS_BASE 0x100000u
+#define HOST_ARENA_PAGES ((VMM_KHEAP_END - VMM_KHEAP_START) / PAGE_SIZE)
+
+static bool console_enabled = false;
+static uint64_t arena_frames[HOST_ARENA_PAGES];   // arena 페이지 -> 프레임 (0이면 매핑 안 됨)
+static uint32_t arena_mapped = 0;
+
+void host_console_enable(bool enable) {
+    console_enabled = enable;
+}
+
+// 콘솔 (커널 메시지는 기본적으로 버림)
+void console_init(void* info) {
+    (void)info;
+}
+
+void console_clear(void) {
+}
+
+void console_putc(char c) {
+    if (console_enabled) {
+        putchar(c);
+    }
+}
+
+void console_puts(const char* s) {
+    if (console_enabled) {
+        fputs(s, stdout);
+    }
+}
+
+// TSC (pmm_init 시간 측정용, 보정 안 된 상태로 둠)
+void tsc_init(void) {
+}
+
+uint32_t tsc_get_khz(void) {
+    return 0;
+}
+
+uint32_t tsc_cycles_to_us(uint64_t cycles) {
+    (void)cycles;
+    return 0;
+}
+
+// VMM: 커널 힙 arena만 흉내냄
+bool vmm_cpu_has_pae(void) {
+    return false;
+}
+
+vmm_paging_mode_t vmm_get_paging_mode(void) {
+    return VMM_PAGING_LEGACY;
+}
+
+void* vmm_get_kernel_page_dir(void) {
+    return arena_frames;
+}
+
+static bool arena_index(void* virt_addr, uint32_t* index) {
+    uintptr_t virt = (uintptr_t)virt_addr;
+    if (virt < VMM_KHEAP_START || virt >= VMM_KHEAP_END) {
+        return false;
+    }
+    *index = (uint32_t)((virt - VMM_KHEAP_START) / PAGE_SIZE);
+    return true;
+}
+
+bool vmm_map_phys(void* page_dir, void* virt_addr, uint64_t phys_addr, uint32_t flags) {
+    (void)page_dir;
+    (void)flags;
+    uint32_t index;
+    if (!arena_index(virt_addr, &index) || arena_frames[index] || !phys_addr) {
+        return false;
+    }
+    arena_frames[index] = phys_addr;
+    arena_mapped++;
+    return true;
+}
+
+bool vmm_unmap_page(void* page_dir, void* virt_addr) {
+    (void)page_dir;
+    uint32_t index;
+    if (!arena_index(virt_addr, &index) || !arena_frames[index]) {
+        return false;
+    }
+    arena_frames[index] = 0;
+    arena_mapped--;
+    return true;
+}
+
+uint64_t vmm_lookup_phys(void* page_dir, void* virt_addr) {
+    (void)page_dir;
+    uint32_t index;
+    return arena_index(virt_addr, &index) ? arena_frames[index] : 0;
+}
+
+uint32_t host_mapped_pages(void) {
+    return arena_mapped;
+}
+
+// 가짜 멀티부트2 정보: 하위 640KB + [1MB, mem_mb) usable, 4GB 바로 아래 BIOS 영역 예약
+// GRUB처럼 usable 메모리 안(첫 페이지)에 두고 physmap 주소로 넘김 (memblock이 예약함)
+static void* host_make_mbinfo(uint32_t mem_mb) {
+    uint8_t* mbinfo = (uint8_t*)vmm_phys_to_virt(HOST_PHYS_BASE);
+    struct multiboot_mmap_entry entries[] = {
+        { 0, 0x9F000, 1, 0 },
+        { HOST_PHYS_BASE, (uint64_t)mem_mb * 0x100000 - HOST_PHYS_BASE, 1, 0 },
+        { 0xFFFC0000, 0x40000, 2, 0 },
+    };
+
+    memset(mbinfo, 0, 256);
+    struct multiboot_tag_mmap* tag = (struct multiboot_tag_mmap*)(mbinfo + 8);
+    tag->type = MB2_TAG_TYPE_MMAP;
+    tag->entry_size = sizeof(struct multiboot_mmap_entry);
+    tag->entry_version = 0;
+    tag->size = sizeof(*tag) + sizeof(entries);
+    memcpy(tag + 1, entries, sizeof(entries));
+
+    struct multiboot_tag* end = (struct multiboot_tag*)(mbinfo + 8 + ((tag->size + 7) & ~7u));
+    end->type = MB2_TAG_TYPE_END;
+    end->size = 8;
+    ((uint32_t*)mbinfo)[0] = (uint32_t)((uint8_t*)(end + 1) - mbinfo);
+    return mbinfo;
+}
+
+bool host_boot(uint32_t mem_mb) {
+    if (mem_mb < 8 || mem_mb > 3072) {
+        fprintf(stderr, "host-bench: memory size must be 8..3072 MB\n");
+        return false;
+    }
+
+    // 커널이 physmap으로 매핑하는 범위(DMA + NORMAL)만 같은 가상 주소에 만들면 됨
+    // HIGH 프레임은 힙 arena에 매핑될 뿐 프레임 자체를 건드리지 않음
+    uint64_t phys_end = (uint64_t)mem_mb * 0x100000;
+    if (phys_end > PMM_NORMAL_LIMIT) {
+        phys_end = PMM_NORMAL_LIMIT;
+    }
+    if (mmap(vmm_phys_to_virt(HOST_PHYS_BASE), phys_end - HOST_PHYS_BASE, PROT_READ | PROT_WRITE,
+             MAP_FIXED_NOREPLACE | MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0) == MAP_FAILED) {
+        perror("host-bench: mmap physical memory");
+        return false;
+    }
+    if (mmap((void*)(uintptr_t)VMM_KHEAP_START, VMM_KHEAP_END - VMM_KHEAP_START, PROT_READ | PROT_WRITE,
+             MAP_FIXED_NOREPLACE | MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0) == MAP_FAILED) {
+        perror("host-bench: mmap kernel heap arena");
+        return false;
+    }
+
+    memblock_init(MB2_MAGIC, host_make_mbinfo(mem_mb));
+    pmm_init();
+    kmalloc_init();
+    return true;
+}
@@ -0,0 +1,564 @@
+#include "hostbench.h"
+#include "mem/pmm.h"
+#include "mem/kmalloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// 할당 trace 재생기
+//
+// trace 파일 형식 (한 줄에 연산 하나, '#' 뒤는 주석):
+//   a <id> <size>           kmalloc
+//   A <id> <size> <align>   kmalloc_aligned
+//   r <id> <size>           krealloc (id가 비어 있으면 kmalloc처럼 동작)
+//   f <id>                  kfree
+//   p <id> <order>          pmm_alloc_order
+//   P <id>                  pmm_free_order
+// id는 trace 안에서 살아 있는 객체 이름 (해제 후 재사용 가능)
+//
+// 파일로 받은 trace 외에 합성 workload를 seed로 만들어 같은 재생기로 돌림
+// 연산마다 CLOCK_MONOTONIC으로 시간을 재서 종류별 지연 백분위를 내고,
+// 재생이 끝난 시점의 힙/버디 상태로 단편화를 계산함
+
+typedef enum {
+    OP_KMALLOC = 0,
+    OP_KMALLOC_ALIGNED,
+    OP_KREALLOC,
+    OP_KFREE,
+    OP_PMM_ALLOC,
+    OP_PMM_FREE,
+    OP_KIND_COUNT,
+} op_kind_t;
+
+static const char* const op_names[OP_KIND_COUNT] = {
+    "kmalloc", "kmalloc_aligned", "krealloc", "kfree", "pmm_alloc", "pmm_free",
+};
+
+typedef struct trace_op {
+    uint8_t kind;
+    uint32_t id;
+    uint32_t size;      // 바이트 (pmm 연산은 order)
+    uint32_t align;
+} trace_op_t;
+
+typedef struct trace {
+    char name[64];
+    trace_op_t* ops;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t max_id;
+} trace_t;
+
+// 살아 있는 객체 (재생 중 검증용 태그 포함)
+typedef struct slot {
+    void* ptr;
+    uint32_t size;
+    uint8_t order;
+    uint8_t tag;
+    bool is_pages;      // pmm_alloc_order 블록
+} slot_t;
+
+static uint32_t errors = 0;
+static bool show_console = false;
+
+static void trace_init(trace_t* trace, const char* name) {
+    memset(trace, 0, sizeof(*trace));
+    snprintf(trace->name, sizeof(trace->name), "%s", name);
+}
+
+static void trace_push(trace_t* trace, op_kind_t kind, uint32_t id, uint32_t size, uint32_t align) {
+    if (trace->count == trace->capacity) {
+        trace->capacity = trace->capacity ? trace->capacity * 2 : 1024;
+        trace->ops = realloc(trace->ops, trace->capacity * sizeof(trace_op_t));
+        if (!trace->ops) {
+            fprintf(stderr, "host-bench: out of memory for trace\n");
+            exit(1);
+        }
+    }
+    trace->ops[trace->count++] = (trace_op_t){ (uint8_t)kind, id, size, align };
+    if (id > trace->max_id) {
+        trace->max_id = id;
+    }
+}
+
+static bool trace_load(trace_t* trace, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    const char* base = strrchr(path, '/');
+    trace_init(trace, base ? base + 1 : path);
+
+    char line[256];
+    uint32_t line_no = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line_no++;
+        char* comment = strchr(line, '#');
+        if (comment) {
+            *comment = '\0';
+        }
+
+        char op;
+        unsigned id = 0, size = 0, align = 0;
+        int fields = sscanf(line, " %c %u %u %u", &op, &id, &size, &align);
+        if (fields <= 0) {
+            continue;
+        }
+
+        bool ok = true;
+        switch (op) {
+        case 'a': ok = fields == 3; trace_push(trace, OP_KMALLOC, id, size, 0); break;
+        case 'A': ok = fields == 4; trace_push(trace, OP_KMALLOC_ALIGNED, id, size, align); break;
+        case 'r': ok = fields == 3; trace_push(trace, OP_KREALLOC, id, size, 0); break;
+        case 'f': ok = fields == 2; trace_push(trace, OP_KFREE, id, 0, 0); break;
+        case 'p': ok = fields == 3 && size <= PMM_MAX_ORDER; trace_push(trace, OP_PMM_ALLOC, id, size, 0); break;
+        case 'P': ok = fields == 2; trace_push(trace, OP_PMM_FREE, id, 0, 0); break;
+        default: ok = false; break;
+        }
+        if (!ok) {
+            fprintf(stderr, "%s:%u: malformed trace line\n", path, line_no);
+            fclose(file);
+            return false;
+        }
+    }
+
+    fclose(file);
+    return true;
+}
+
+// 합성 workload용 난수 (xorshift32, seed가 같으면 어느 호스트에서나 같은 trace)
+static uint32_t rng_state = 1;
+
+static uint32_t rng_next(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng_state = x;
+    return x;
+}
+
+static uint32_t rng_range(uint32_t lo, uint32_t hi) {
+    return lo + rng_next() % (hi - lo + 1);
+}
+
+// 살아 있는 id 집합 (합성 trace 생성용)
+typedef struct live_set {
+    uint32_t* ids;
+    uint32_t count;
+    uint32_t next_id;
+} live_set_t;
+
+static void live_init(live_set_t* live, uint32_t capacity) {
+    live->ids = calloc(capacity, sizeof(uint32_t));
+    live->count = 0;
+    live->next_id = 0;
+}
+
+static uint32_t live_add(live_set_t* live) {
+    uint32_t id = live->next_id++;
+    live->ids[live->count++] = id;
+    return id;
+}
+
+static uint32_t live_take(live_set_t* live) {
+    uint32_t k = rng_next() % live->count;
+    uint32_t id = live->ids[k];
+    live->ids[k] = live->ids[--live->count];
+    return id;
+}
+
+// 작은 커널 객체 (task, channel, 노드 등) 위주, 살아 있는 객체 4096개 근처에서 정상 상태
+static void synth_small(trace_t* trace, uint32_t ops) {
+    static const uint32_t sizes[] = { 8, 12, 16, 24, 32, 40, 48, 64, 96, 128, 192, 256 };
+    live_set_t live;
+    live_init(&live, ops);
+    trace_init(trace, "synthetic: small objects");
+
+    for (uint32_t i = 0; i < ops; i++) {
+        bool alloc = live.count == 0 || (live.count < 4096 && (rng_next() & 1));
+        if (alloc) {
+            uint32_t size = sizes[rng_next() % (sizeof(sizes) / sizeof(sizes[0]))];
+            trace_push(trace, OP_KMALLOC, live_add(&live), size, 0);
+        } else {
+            trace_push(trace, OP_KFREE, live_take(&live), 0, 0);
+        }
+    }
+    free(live.ids);
+}
+
+// 작은/중간/큰 크기 혼합 + 정렬 할당 + krealloc
+static void synth_mixed(trace_t* trace, uint32_t ops) {
+    live_set_t live;
+    live_init(&live, ops);
+    trace_init(trace, "synthetic: mixed sizes");
+
+    for (uint32_t i = 0; i < ops; i++) {
+        uint32_t dice = rng_next() % 100;
+        if (live.count == 0 || (live.count < 2048 && dice < 50)) {
+            uint32_t kind = rng_next() % 100;
+            uint32_t size = kind < 75 ? rng_range(1, 200) : kind < 97 ? rng_range(1, 5000) : rng_range(1, 200000);
+            if (rng_next() % 20 == 0) {
+                trace_push(trace, OP_KMALLOC_ALIGNED, live_add(&live), size, 1u << rng_range(5, 12));
+            } else {
+                trace_push(trace, OP_KMALLOC, live_add(&live), size, 0);
+            }
+        } else if (dice < 65) {
+            uint32_t id = live.ids[rng_next() % live.count];
+            trace_push(trace, OP_KREALLOC, id, rng_range(1, rng_next() % 4 ? 400 : 50000), 0);
+        } else {
+            trace_push(trace, OP_KFREE, live_take(&live), 0, 0);
+        }
+    }
+    free(live.ids);
+}
+
+// 묶음으로 할당하고 역순으로 해제 (요청 처리 중 임시 버퍼 패턴)
+static void synth_lifo(trace_t* trace, uint32_t ops) {
+    uint32_t batch[512];
+    uint32_t id = 0;
+    trace_init(trace, "synthetic: LIFO batches");
+
+    while (trace->count < ops) {
+        uint32_t n = rng_range(16, 512);
+        for (uint32_t i = 0; i < n; i++) {
+            batch[i] = id++;
+            trace_push(trace, OP_KMALLOC, batch[i], rng_range(16, 1024), 0);
+        }
+        while (n--) {
+            trace_push(trace, OP_KFREE, batch[n], 0, 0);
+        }
+    }
+}
+
+// 버디 할당자: order 0 위주에 가끔 큰 블록
+static void synth_pages(trace_t* trace, uint32_t ops) {
+    live_set_t live;
+    live_init(&live, ops);
+    trace_init(trace, "synthetic: pmm orders");
+
+    for (uint32_t i = 0; i < ops; i++) {
+        bool alloc = live.count == 0 || (live.count < 2048 && (rng_next() & 1));
+        if (alloc) {
+            uint32_t dice = rng_next() % 100;
+            uint32_t order = dice < 70 ? 0 : dice < 90 ? 1 : dice < 98 ? 2 : rng_range(3, 5);
+            trace_push(trace, OP_PMM_ALLOC, live_add(&live), order, 0);
+        } else {
+            trace_push(trace, OP_PMM_FREE, live_take(&live), 0, 0);
+        }
+    }
+    free(live.ids);
+}
+
+static inline uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void report_error(const trace_t* trace, uint32_t index, const char* what) {
+    if (errors++ < 10) {
+        fprintf(stderr, "  ERROR %s: op %u: %s\n", trace->name, index, what);
+    }
+}
+
+// 객체 앞뒤 바이트에 태그를 남기고 해제/이동 때 확인 (덮어쓰기 감지)
+static void slot_stamp(slot_t* slot) {
+    uint8_t* bytes = slot->ptr;
+    bytes[0] = slot->tag;
+    bytes[slot->size - 1] = slot->tag;
+}
+
+static bool slot_intact(const slot_t* slot) {
+    const uint8_t* bytes = slot->ptr;
+    return bytes[0] == slot->tag && bytes[slot->size - 1] == slot->tag;
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile(const uint32_t* sorted, uint32_t count, uint32_t per_mille) {
+    uint64_t rank = (uint64_t)count * per_mille / 1000;
+    return sorted[rank < count ? rank : count - 1];
+}
+
+// 버디 단편화: 가장 큰 free order, order 4(64KB) 미만 블록에 묶인 free 페이지 비율
+static void report_pmm(void) {
+    uint32_t free_pages = 0;
+    uint32_t small_pages = 0;
+    int largest = -1;
+    for (uint32_t zone = 0; zone < PMM_ZONE_COUNT; zone++) {
+        for (uint32_t order = 0; order <= PMM_MAX_ORDER; order++) {
+            uint32_t blocks = pmm_zone_free_blocks((pmm_zone_id_t)zone, order);
+            free_pages += blocks << order;
+            if (order < 4) {
+                small_pages += blocks << order;
+            }
+            if (blocks && (int)order > largest) {
+                largest = (int)order;
+            }
+        }
+    }
+    printf("  pmm: %u free pages in buddies, largest free order %d, %.1f%% in blocks below order 4\n",
+           free_pages, largest, free_pages ? 100.0 * small_pages / free_pages : 0.0);
+}
+
+static void replay(const trace_t* trace) {
+    slot_t* slots = calloc(trace->max_id + 1, sizeof(slot_t));
+    uint32_t* latencies[OP_KIND_COUNT];
+    uint32_t counts[OP_KIND_COUNT] = { 0 };
+    for (uint32_t k = 0; k < OP_KIND_COUNT; k++) {
+        latencies[k] = malloc((trace->count + 1) * sizeof(uint32_t));
+    }
+
+    uint32_t peak_used = 0;
+    uint32_t peak_total = 0;
+    uint32_t failed = 0;
+    uint32_t start_errors = errors;
+    uint64_t busy_ns = 0;
+    uint64_t wall_start = now_ns();
+
+    for (uint32_t i = 0; i < trace->count; i++) {
+        const trace_op_t* op = &trace->ops[i];
+        slot_t* slot = &slots[op->id];
+        void* result = NULL;
+        uint64_t t0, t1;
+
+        if ((op->kind == OP_KMALLOC || op->kind == OP_KMALLOC_ALIGNED || op->kind == OP_PMM_ALLOC) && slot->ptr) {
+            report_error(trace, i, "id already live");
+            continue;
+        }
+        if ((op->kind == OP_KFREE || op->kind == OP_PMM_FREE) && !slot->ptr) {
+            report_error(trace, i, "id not live");
+            continue;
+        }
+        if ((op->kind == OP_KFREE || op->kind == OP_KREALLOC) && slot->ptr && !slot_intact(slot)) {
+            report_error(trace, i, "object tag overwritten");
+        }
+
+        switch (op->kind) {
+        case OP_KMALLOC:
+            t0 = now_ns();
+            result = kmalloc(op->size);
+            t1 = now_ns();
+            break;
+        case OP_KMALLOC_ALIGNED:
+            t0 = now_ns();
+            result = kmalloc_aligned(op->size, op->align);
+            t1 = now_ns();
+            if (result && ((uintptr_t)result & (op->align - 1))) {
+                report_error(trace, i, "misaligned kmalloc_aligned result");
+            }
+            break;
+        case OP_KREALLOC:
+            t0 = now_ns();
+            result = krealloc(slot->ptr, op->size);
+            t1 = now_ns();
+            break;
+        case OP_KFREE:
+            t0 = now_ns();
+            if (!kfree(slot->ptr)) {
+                report_error(trace, i, "kfree rejected a live pointer");
+            }
+            t1 = now_ns();
+            break;
+        case OP_PMM_ALLOC:
+            t0 = now_ns();
+            result = pmm_alloc_order(op->size);
+            t1 = now_ns();
+            break;
+        default:
+            t0 = now_ns();
+            if (!pmm_free_order(slot->ptr, slot->order)) {
+                report_error(trace, i, "pmm_free_order rejected a live block");
+            }
+            t1 = now_ns();
+            break;
+        }
+
+        uint32_t elapsed = (uint32_t)(t1 - t0);
+        latencies[op->kind][counts[op->kind]++] = elapsed;
+        busy_ns += elapsed;
+
+        if (op->kind == OP_KFREE || op->kind == OP_PMM_FREE) {
+            slot->ptr = NULL;
+        } else if (!result) {
+            // 실패한 krealloc은 원래 블록을 그대로 둠
+            failed++;
+        } else {
+            slot->ptr = result;
+            slot->size = op->kind == OP_PMM_ALLOC ? PAGE_SIZE : op->size;
+            slot->order = (uint8_t)(op->kind == OP_PMM_ALLOC ? op->size : 0);
+            slot->is_pages = op->kind == OP_PMM_ALLOC;
+            slot->tag = (uint8_t)(i * 31 + 7);
+            slot_stamp(slot);
+        }
+
+        if (kmalloc_used_bytes() > peak_used) {
+            peak_used = kmalloc_used_bytes();
+            peak_total = kmalloc_total_bytes();
+        }
+    }
+
+    uint64_t wall_ns = now_ns() - wall_start;
+
+    printf("\n== %s (%u ops) ==\n", trace->name, trace->count);
+    printf("  throughput: %.2f Mops/s allocator time, %.2f Mops/s wall (incl. timing + checks)\n",
+           busy_ns ? trace->count * 1000.0 / busy_ns : 0.0,
+           wall_ns ? trace->count * 1000.0 / wall_ns : 0.0);
+    printf("  %-16s %9s %7s %7s %7s %7s %9s  (ns)\n", "op", "count", "p50", "p90", "p99", "p99.9", "max");
+    for (uint32_t k = 0; k < OP_KIND_COUNT; k++) {
+        uint32_t n = counts[k];
+        if (n == 0) {
+            continue;
+        }
+        qsort(latencies[k], n, sizeof(uint32_t), compare_u32);
+        printf("  %-16s %9u %7u %7u %7u %7u %9u\n", op_names[k], n,
+               percentile(latencies[k], n, 500), percentile(latencies[k], n, 900),
+               percentile(latencies[k], n, 990), percentile(latencies[k], n, 999), latencies[k][n - 1]);
+    }
+    if (failed) {
+        printf("  %u allocations failed (out of memory)\n", failed);
+    }
+
+    // 재생이 끝난 시점 (남은 객체를 풀기 전) 힙 상태
+    uint32_t used = kmalloc_used_bytes();
+    uint32_t free_bytes = kmalloc_free_bytes();
+    uint32_t holes = kmalloc_hole_bytes();
+    uint32_t total = kmalloc_total_bytes();
+    uint32_t largest = kmalloc_largest_free_block();
+    if ((uint64_t)used + free_bytes > total) {
+        report_error(trace, trace->count, "used + free heap bytes exceed mapped heap size");
+    }
+    printf("  heap: %u KB mapped, %u KB used, %u KB free (+%u KB returned), largest free block %u KB\n",
+           total / 1024, used / 1024, free_bytes / 1024, holes / 1024, largest / 1024);
+    // 가장 큰 블록 크기에는 구멍이 들어 있으므로 구멍 포함 free와 비교
+    printf("  fragmentation: external %.1f%%, utilisation %.1f%% (at peak %.1f%%)\n",
+           free_bytes + holes ? 100.0 * (1.0 - (double)largest / (free_bytes + holes)) : 0.0,
+           total ? 100.0 * used / total : 0.0,
+           peak_total ? 100.0 * peak_used / peak_total : 0.0);
+    report_pmm();
+    if (kmalloc_profile_enabled()) {
+        host_console_enable(true);
+        kmalloc_profile_dump();
+        host_console_enable(show_console);
+    }
+
+    // 남은 객체 정리 (측정 밖), 다음 trace는 빈 힙에서 시작
+    for (uint32_t id = 0; id <= trace->max_id; id++) {
+        slot_t* slot = &slots[id];
+        if (!slot->ptr) {
+            continue;
+        }
+        if (!slot_intact(slot)) {
+            report_error(trace, trace->count, "object tag overwritten at cleanup");
+        }
+        if (slot->is_pages) {
+            pmm_free_order(slot->ptr, slot->order);
+        } else {
+            kfree(slot->ptr);
+        }
+    }
+    if (kmalloc_used_bytes() != 0) {
+        report_error(trace, trace->count, "kmalloc_used_bytes not zero after freeing everything");
+    }
+    if ((uint64_t)host_mapped_pages() * PAGE_SIZE != kmalloc_total_bytes()) {
+        report_error(trace, trace->count, "heap mapping count disagrees with kmalloc_total_bytes");
+    }
+    if ((uint64_t)kmalloc_used_bytes() + kmalloc_free_bytes() > kmalloc_total_bytes()) {
+        report_error(trace, trace->count, "used + free heap bytes exceed mapped heap size");
+    }
+    if (errors != start_errors) {
+        printf("  %u errors\n", errors - start_errors);
+    }
+
+    for (uint32_t k = 0; k < OP_KIND_COUNT; k++) {
+        free(latencies[k]);
+    }
+    free(slots);
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "usage: %s [-m MB] [-n OPS] [-s SEED] [-t BYTES] [-p] [-v] [trace ...]\n"
+            "  -m MB     usable memory in the fake multiboot map (default 128)\n"
+            "  -n OPS    operations per synthetic workload (default 200000, 0 = traces only)\n"
+            "  -s SEED   synthetic workload seed (default 1)\n"
+            "  -t BYTES  kmalloc shrink threshold (default %u, 0 = never shrink)\n"
+            "  -p        enable kmalloc profiling and dump it after each trace\n"
+            "  -v        show kernel console output\n",
+            prog, KMALLOC_SHRINK_THRESHOLD_DEFAULT);
+}
+
+int main(int argc, char** argv) {
+    uint32_t mem_mb = 128;
+    uint32_t ops = 200000;
+    uint32_t seed = 1;
+    long threshold = -1;
+    bool profile = false;
+    int arg = 1;
+
+    for (; arg < argc && argv[arg][0] == '-'; arg++) {
+        char flag = argv[arg][1];
+        if (flag == 'v') {
+            show_console = true;
+            host_console_enable(true);
+            continue;
+        }
+        if (flag == 'p') {
+            profile = true;
+            continue;
+        }
+        if (arg + 1 >= argc || (flag != 'm' && flag != 'n' && flag != 's' && flag != 't')) {
+            usage(argv[0]);
+            return 2;
+        }
+        unsigned long value = strtoul(argv[++arg], NULL, 0);
+        switch (flag) {
+        case 'm': mem_mb = (uint32_t)value; break;
+        case 'n': ops = (uint32_t)value; break;
+        case 's': seed = (uint32_t)value ? (uint32_t)value : 1; break;
+        default: threshold = (long)value; break;
+        }
+    }
+
+    if (!host_boot(mem_mb)) {
+        return 1;
+    }
+    if (threshold >= 0) {
+        kmalloc_set_shrink_threshold((uint32_t)threshold);
+    }
+    kmalloc_profile_enable(profile);
+    printf("host-bench: %u MB, %u pages managed, seed %u\n", mem_mb, pmm_total_pages(), seed);
+
+    trace_t trace;
+    for (; arg < argc; arg++) {
+        if (!trace_load(&trace, argv[arg])) {
+            return 1;
+        }
+        replay(&trace);
+        free(trace.ops);
+    }
+
+    if (ops) {
+        void (*const generators[])(trace_t*, uint32_t) = { synth_small, synth_mixed, synth_lifo, synth_pages };
+        for (uint32_t g = 0; g < sizeof(generators) / sizeof(generators[0]); g++) {
+            rng_state = seed;
+            generators[g](&trace, ops);
+            replay(&trace);
+            free(trace.ops);
+        }
+    }
+
+    if (errors) {
+        printf("\nhost-bench: %u errors\n", errors);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// host-bench: pmm.c / kmalloc.c를 리눅스에서 네이티브로 빌드해 할당 trace를 재생
+//
+// 커널의 물리 주소 = 호스트 가상 주소가 되도록 [1MB, 메모리 끝)을 같은 주소에 mmap하고,
+// 커널 힙 arena [VMM_KHEAP_START, VMM_KHEAP_END)도 같은 주소에 예약함
+// vmm_map_phys/vmm_unmap_page는 페이지 테이블 대신 arena 페이지별 표로 흉내냄
+
+// 호스트에 물리 메모리/힙 arena를 만들고 memblock -> pmm -> kmalloc 순으로 초기화
+// mem_mb: 가짜 멀티부트 맵의 usable 메모리 크기 (MB, 1MB부터)
+bool host_boot(uint32_t mem_mb);
+
+// 현재 arena에서 매핑된 페이지 수 (kmalloc_total_bytes와 일치해야 함)
+uint32_t host_mapped_pages(void);
+
+// 커널 콘솔 출력을 stdout으로 보낼지 (기본: 끔)
+void host_console_enable(bool enable);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+// host-bench용 irqflags: 유저 공간에서는 cli/sti를 쓸 수 없고 인터럽트도 없으므로 빈 임계 구역
+// include 경로에서 커널의 arch/x86/irqflags.h보다 먼저 잡힘
+static inline uint32_t irq_save(void) {
+    return 0;
+}
+
+static inline void irq_restore(uint32_t flags) {
+    (void)flags;
+}